@@ -0,0 +1,26 @@
+/**
+ * @file device_config.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief The group the host scenarios run with, larger than the peer list so
+ * that it scrolls
+ * @version 0.1
+ * @date 2025-07-31
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "Astrolavos_types.hpp"
+
+namespace astrolavos
+{
+paired_device_auto_config_t
+    paired_device_auto_config[ASTROLAVOS_NUMBER_OF_DEVICES] = {
+        {0, "Evan", 0x07FF},  {1, "Fotis", 0x07E0}, {2, "Bob", 0xF800},
+        {3, "Alice", 0xF81F}, {4, "Nikos", 0xFFE0}, {5, "Maria", 0xFD20},
+        {6, "Eleni", 0x841F}, {7, "Kosta", 0xFFFF}, {8, "Dora", 0x07EF},
+        {9, "Petro", 0xFB56}};
+
+paired_device_auto_config_t this_device = {
+    .id = 0, .name = "Evan", .colour = 0x07FF};
+} // namespace astrolavos
@@ -0,0 +1,179 @@
+/**
+ * @file esp_idf.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host implementation of the ESP-IDF calls the display and the
+ * application make. The ST7735 pins, the SPI bus and the backlight channel
+ * drive the emulator.
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "driver/gpio.h"
+#include "driver/ledc.h"
+#include "driver/spi_master.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "st7735_emulator.hpp"
+#include <atomic>
+#include <deque>
+
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+static std::atomic<int64_t> host_clock_us{0};
+static uint32_t gpio_levels[GPIO_NUM_MAX];
+static uint32_t ledc_max_duty = (1 << LEDC_TIMER_10_BIT) - 1;
+
+const char* esp_err_to_name(esp_err_t code)
+{
+    switch (code)
+    {
+        case ESP_OK:
+            return "ESP_OK";
+        case ESP_ERR_NO_MEM:
+            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:
+            return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:
+            return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_TIMEOUT:
+            return "ESP_ERR_TIMEOUT";
+        default:
+            return "ESP_FAIL";
+    }
+}
+
+int64_t esp_timer_get_time() { return host_clock_us; }
+
+void host_clock_advance(int64_t us) { host_clock_us += us; }
+
+/* ---------------------------------- GPIO --------------------------------- */
+
+esp_err_t gpio_config(const gpio_config_t*) { return ESP_OK; }
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+    if (pin < 0 || pin >= GPIO_NUM_MAX)
+        return ESP_ERR_INVALID_ARG;
+    gpio_levels[pin] = level;
+    st7735_emulator::panel().set_pin(pin, level);
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    if (pin < 0 || pin >= GPIO_NUM_MAX)
+        return 0;
+    return gpio_levels[pin];
+}
+
+/* The driver holds the panel pins between frames, which marks the frames */
+esp_err_t gpio_hold_en(gpio_num_t pin)
+{
+    if (pin == ST7735_CS_Pin)
+        st7735_emulator::panel().hold_pins(true);
+    return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t pin)
+{
+    if (pin == ST7735_CS_Pin)
+        st7735_emulator::panel().hold_pins(false);
+    return ESP_OK;
+}
+
+/* ---------------------------------- LEDC --------------------------------- */
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* config)
+{
+    ledc_max_duty = (1u << config->duty_resolution) - 1;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t* config)
+{
+    st7735_emulator::panel().set_backlight(config->duty, ledc_max_duty);
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_func_install(int) { return ESP_OK; }
+
+esp_err_t ledc_set_duty_and_update(ledc_mode_t, ledc_channel_t, uint32_t duty,
+                                   uint32_t)
+{
+    st7735_emulator::panel().set_backlight(duty, ledc_max_duty);
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t, ledc_channel_t,
+                                       uint32_t duty, uint32_t,
+                                       ledc_fade_mode_t)
+{
+    st7735_emulator::panel().set_backlight(duty, ledc_max_duty);
+    return ESP_OK;
+}
+
+/* ---------------------------------- SPI ---------------------------------- */
+
+struct spi_device_t
+{
+    spi_device_interface_config_t config;
+    std::deque<spi_transaction_t*> done; /* Queued and not collected yet */
+};
+
+static void spi_clock_out(spi_device_handle_t dev, spi_transaction_t* t)
+{
+    if (dev->config.pre_cb)
+        dev->config.pre_cb(t);
+    const uint8_t* data = (t->flags & SPI_TRANS_USE_TXDATA)
+                              ? t->tx_data
+                              : static_cast<const uint8_t*>(t->tx_buffer);
+    st7735_emulator::panel().transfer(data, (t->length + 7) / 8);
+    if (dev->config.post_cb)
+        dev->config.post_cb(t);
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t, const spi_bus_config_t*, int)
+{
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t,
+                             const spi_device_interface_config_t* config,
+                             spi_device_handle_t* handle)
+{
+    *handle = new spi_device_t{*config, {}};
+    return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t dev,
+                                      spi_transaction_t* t)
+{
+    /* As on the target, a polling transfer may not overtake queued ones */
+    if (!dev->done.empty())
+        return ESP_ERR_INVALID_STATE;
+    spi_clock_out(dev, t);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t dev, spi_transaction_t* t,
+                                 TickType_t)
+{
+    if (static_cast<int>(dev->done.size()) >= dev->config.queue_size)
+        return ESP_ERR_TIMEOUT;
+    spi_clock_out(dev, t);
+    dev->done.push_back(t);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t dev,
+                                      spi_transaction_t** t, TickType_t)
+{
+    if (dev->done.empty())
+        return ESP_ERR_TIMEOUT;
+    *t = dev->done.front();
+    dev->done.pop_front();
+    return ESP_OK;
+}
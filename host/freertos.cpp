@@ -0,0 +1,178 @@
+/**
+ * @file freertos.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host implementation of the FreeRTOS calls on std::thread
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct host_task
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    uint32_t notifications = 0;
+};
+
+struct host_queue
+{
+    std::mutex lock;
+    std::condition_variable cv;
+    size_t length;
+    size_t item_size;
+    std::deque<std::vector<uint8_t>> items;
+};
+
+struct host_mutex
+{
+    std::timed_mutex lock;
+};
+
+/* Threads that are not tasks, like main(), get a task on first use */
+static thread_local host_task* current_task = nullptr;
+
+/* Waits for a predicate, in real time unless the wait is portMAX_DELAY */
+template <typename Lock, typename Predicate>
+static bool host_wait(std::condition_variable& cv, Lock& lock, TickType_t wait,
+                      Predicate ready)
+{
+    if (wait == portMAX_DELAY)
+    {
+        cv.wait(lock, ready);
+        return true;
+    }
+    return cv.wait_for(lock, std::chrono::milliseconds(wait), ready);
+}
+
+/* ---------------------------------- Tasks -------------------------------- */
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char*, uint32_t, void* args,
+                       UBaseType_t, TaskHandle_t* handle)
+{
+    host_task* t = new host_task;
+    if (handle)
+        *handle = t;
+    std::thread(
+        [task, args, t]
+        {
+            current_task = t;
+            task(args);
+        })
+        .detach();
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+    if (!current_task)
+        current_task = new host_task;
+    return current_task;
+}
+
+void vTaskDelay(TickType_t ticks) { host_clock_advance(ticks * 1000LL); }
+
+TickType_t xTaskGetTickCount() { return esp_timer_get_time() / 1000; }
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    {
+        std::lock_guard<std::mutex> guard(task->lock);
+        task->notifications++;
+    }
+    task->cv.notify_all();
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken)
+{
+    xTaskNotifyGive(task);
+    if (woken)
+        *woken = pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait)
+{
+    host_task* t = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> lock(t->lock);
+    host_wait(t->cv, lock, wait, [t] { return t->notifications > 0; });
+    const uint32_t value = t->notifications;
+    if (value)
+        t->notifications = clear ? 0 : value - 1;
+    return value;
+}
+
+/* ---------------------------------- Queues ------------------------------- */
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    host_queue* q = new host_queue;
+    q->length = length;
+    q->item_size = item_size;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!host_wait(q->cv, lock, wait,
+                   [q] { return q->items.size() < q->length; }))
+        return pdFALSE;
+    const uint8_t* bytes = static_cast<const uint8_t*>(item);
+    q->items.emplace_back(bytes, bytes + q->item_size);
+    lock.unlock();
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t wait)
+{
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!host_wait(q->cv, lock, wait, [q] { return !q->items.empty(); }))
+        return pdFALSE;
+    memcpy(item, q->items.front().data(), q->item_size);
+    q->items.pop_front();
+    lock.unlock();
+    q->cv.notify_all();
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    std::lock_guard<std::mutex> guard(q->lock);
+    return q->items.size();
+}
+
+/* ---------------------------------- Mutexes ------------------------------ */
+
+SemaphoreHandle_t xSemaphoreCreateMutex() { return new host_mutex; }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t m, TickType_t wait)
+{
+    if (wait == portMAX_DELAY)
+    {
+        m->lock.lock();
+        return pdTRUE;
+    }
+    return m->lock.try_lock_for(std::chrono::milliseconds(wait)) ? pdTRUE
+                                                                 : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t m)
+{
+    m->lock.unlock();
+    return pdTRUE;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file RadioLib.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of RadioLib, the calls the application makes
+ * outside of the LoRa tasks
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#define RADIOLIB_ERR_NONE 0
+
+class RadioLibHal
+{
+};
+
+class Module
+{
+public:
+    template <typename... Args> explicit Module(Args...) {}
+};
+
+class SX1262
+{
+public:
+    explicit SX1262(Module*) {}
+    int16_t sleep() { return RADIOLIB_ERR_NONE; }
+    int16_t standby() { return RADIOLIB_ERR_NONE; }
+    int16_t startReceive() { return RADIOLIB_ERR_NONE; }
+};
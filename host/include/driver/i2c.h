@@ -0,0 +1,21 @@
+/**
+ * @file i2c.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF I2C driver, enough for the headers
+ * of the sensors
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+typedef enum
+{
+    I2C_NUM_0,
+    I2C_NUM_1
+} i2c_port_t;
@@ -0,0 +1,84 @@
+/**
+ * @file ledc.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF LEDC driver, the duty is kept as
+ * the backlight level of the emulator
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "esp_err.h"
+#include <cstdint>
+
+typedef enum
+{
+    LEDC_LOW_SPEED_MODE
+} ledc_mode_t;
+
+typedef enum
+{
+    LEDC_TIMER_0
+} ledc_timer_t;
+
+typedef enum
+{
+    LEDC_CHANNEL_0
+} ledc_channel_t;
+
+typedef enum
+{
+    LEDC_TIMER_10_BIT = 10
+} ledc_timer_bit_t;
+
+typedef enum
+{
+    LEDC_USE_RC_FAST_CLK
+} ledc_clk_cfg_t;
+
+typedef enum
+{
+    LEDC_SLEEP_MODE_NO_ALIVE_NO_PD,
+    LEDC_SLEEP_MODE_KEEP_ALIVE
+} ledc_sleep_mode_t;
+
+typedef enum
+{
+    LEDC_FADE_NO_WAIT,
+    LEDC_FADE_WAIT_DONE
+} ledc_fade_mode_t;
+
+typedef struct
+{
+    ledc_mode_t speed_mode;
+    ledc_timer_bit_t duty_resolution;
+    ledc_timer_t timer_num;
+    uint32_t freq_hz;
+    ledc_clk_cfg_t clk_cfg;
+} ledc_timer_config_t;
+
+typedef struct
+{
+    int gpio_num;
+    ledc_mode_t speed_mode;
+    ledc_channel_t channel;
+    int intr_type;
+    ledc_timer_t timer_sel;
+    uint32_t duty;
+    int hpoint;
+    ledc_sleep_mode_t sleep_mode;
+} ledc_channel_config_t;
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t* config);
+esp_err_t ledc_channel_config(const ledc_channel_config_t* config);
+esp_err_t ledc_fade_func_install(int intr_flags);
+esp_err_t ledc_set_duty_and_update(ledc_mode_t mode, ledc_channel_t channel,
+                                   uint32_t duty, uint32_t hpoint);
+/* Fades complete at once on the host */
+esp_err_t ledc_set_fade_time_and_start(ledc_mode_t mode,
+                                       ledc_channel_t channel,
+                                       uint32_t duty, uint32_t fade_ms,
+                                       ledc_fade_mode_t fade_mode);
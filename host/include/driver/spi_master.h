@@ -0,0 +1,91 @@
+/**
+ * @file spi_master.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF SPI master driver. Every
+ * transaction is clocked into the emulator when it is queued
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <cstddef>
+#include <cstdint>
+
+typedef enum
+{
+    SPI1_HOST,
+    SPI2_HOST,
+    SPI3_HOST
+} spi_host_device_t;
+
+#define SPI_DMA_CH_AUTO 3
+#define SPI_TRANS_USE_RXDATA (1 << 2)
+#define SPI_TRANS_USE_TXDATA (1 << 3)
+
+typedef struct
+{
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct spi_transaction_t spi_transaction_t;
+typedef void (*transaction_cb_t)(spi_transaction_t* trans);
+
+struct spi_transaction_t
+{
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t length; /* Bits */
+    size_t rxlength;
+    void* user;
+    union
+    {
+        const void* tx_buffer;
+        uint8_t tx_data[4];
+    };
+    union
+    {
+        void* rx_buffer;
+        uint8_t rx_data[4];
+    };
+};
+
+typedef struct
+{
+    uint8_t command_bits;
+    uint8_t address_bits;
+    uint8_t dummy_bits;
+    uint8_t mode;
+    int clock_speed_hz;
+    int spics_io_num;
+    uint32_t flags;
+    int queue_size;
+    transaction_cb_t pre_cb;
+    transaction_cb_t post_cb;
+} spi_device_interface_config_t;
+
+typedef struct spi_device_t* spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host,
+                             const spi_bus_config_t* config, int dma);
+esp_err_t spi_bus_add_device(spi_host_device_t host,
+                             const spi_device_interface_config_t* config,
+                             spi_device_handle_t* handle);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle,
+                                      spi_transaction_t* trans);
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle,
+                                 spi_transaction_t* trans, TickType_t wait);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle,
+                                      spi_transaction_t** trans,
+                                      TickType_t wait);
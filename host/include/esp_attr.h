@@ -0,0 +1,14 @@
+/**
+ * @file esp_attr.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF placement attributes
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#define IRAM_ATTR
+#define DRAM_ATTR
@@ -0,0 +1,45 @@
+/**
+ * @file esp_log.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF logging, printed to stderr
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "esp_err.h"
+#include <cstdio>
+
+typedef enum
+{
+    ESP_LOG_NONE,
+    ESP_LOG_ERROR,
+    ESP_LOG_WARN,
+    ESP_LOG_INFO,
+    ESP_LOG_DEBUG,
+    ESP_LOG_VERBOSE
+} esp_log_level_t;
+
+/* Messages above this level are dropped, ESP_LOG_WARN unless changed */
+extern esp_log_level_t host_log_level;
+
+#define HOST_LOG(level, letter, tag, fmt, ...)                                 \
+    do                                                                         \
+    {                                                                          \
+        if (host_log_level >= level)                                          \
+            fprintf(stderr, letter " (%s) " fmt "\n", tag, ##__VA_ARGS__);     \
+    } while (0)
+
+#define ESP_LOGE(tag, fmt, ...)                                                \
+    HOST_LOG(ESP_LOG_ERROR, "E", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGW(tag, fmt, ...)                                                \
+    HOST_LOG(ESP_LOG_WARN, "W", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGI(tag, fmt, ...)                                                \
+    HOST_LOG(ESP_LOG_INFO, "I", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGD(tag, fmt, ...)                                                \
+    HOST_LOG(ESP_LOG_DEBUG, "D", tag, fmt, ##__VA_ARGS__)
+#define ESP_LOGV(tag, fmt, ...)                                                \
+    HOST_LOG(ESP_LOG_VERBOSE, "V", tag, fmt, ##__VA_ARGS__)
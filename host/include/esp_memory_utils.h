@@ -0,0 +1,15 @@
+/**
+ * @file esp_memory_utils.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF memory region checks
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+/* Host memory is all DMA capable, the copying paths of the driver are only
+ * taken on the target */
+inline bool esp_ptr_dma_capable(const void*) { return true; }
@@ -0,0 +1,31 @@
+/**
+ * @file esp_pm.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF power management locks
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "esp_err.h"
+
+typedef enum
+{
+    ESP_PM_CPU_FREQ_MAX,
+    ESP_PM_APB_FREQ_MAX,
+    ESP_PM_NO_LIGHT_SLEEP
+} esp_pm_lock_type_t;
+
+typedef void* esp_pm_lock_handle_t;
+
+inline esp_err_t esp_pm_lock_create(esp_pm_lock_type_t, int, const char*,
+                                    esp_pm_lock_handle_t* handle)
+{
+    *handle = nullptr;
+    return ESP_OK;
+}
+inline esp_err_t esp_pm_lock_acquire(esp_pm_lock_handle_t) { return ESP_OK; }
+inline esp_err_t esp_pm_lock_release(esp_pm_lock_handle_t) { return ESP_OK; }
@@ -0,0 +1,15 @@
+/**
+ * @file esp_sleep.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF sleep configuration
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "esp_err.h"
+
+inline esp_err_t esp_sleep_enable_gpio_wakeup() { return ESP_OK; }
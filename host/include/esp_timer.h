@@ -0,0 +1,21 @@
+/**
+ * @file esp_timer.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the ESP-IDF timer, on a virtual clock
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Microseconds of the virtual clock. It only moves with vTaskDelay()
+ * and host_clock_advance(), so runs are reproducible.
+ */
+int64_t esp_timer_get_time();
+
+void host_clock_advance(int64_t us);
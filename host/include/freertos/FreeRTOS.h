@@ -0,0 +1,36 @@
+/**
+ * @file FreeRTOS.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the FreeRTOS kernel on std::thread. Ticks
+ * are milliseconds of the virtual clock of esp_timer.h
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdPASS pdTRUE
+#define portMAX_DELAY ((TickType_t)0xffffffffu)
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portYIELD_FROM_ISR(woken) (void)(woken)
+
+typedef struct host_task* TaskHandle_t;
+typedef struct host_queue* QueueHandle_t;
+typedef struct host_mutex* SemaphoreHandle_t;
+
+/* The ESP-IDF headers the sources include make the mutexes visible without
+ * an explicit semphr.h */
+#include "freertos/semphr.h"
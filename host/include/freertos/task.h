@@ -0,0 +1,29 @@
+/**
+ * @file task.h
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the FreeRTOS tasks and notifications
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void* args);
+
+/* Each task is a detached thread, the stack size and priority are ignored */
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name,
+                       uint32_t stack, void* args, UBaseType_t priority,
+                       TaskHandle_t* handle);
+TaskHandle_t xTaskGetCurrentTaskHandle();
+/* Advances the virtual clock instead of sleeping */
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken);
+/* Timeouts other than portMAX_DELAY are waited in real time */
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait);
@@ -0,0 +1,20 @@
+/**
+ * @file radiolib_esp32s3_hal.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-in of the RadioLib ESP32-S3 HAL
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include <RadioLib.h>
+
+class EspHal : public RadioLibHal
+{
+public:
+    EspHal(int8_t sck, int8_t miso, int8_t mosi) {}
+};
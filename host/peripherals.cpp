@@ -0,0 +1,28 @@
+/**
+ * @file peripherals.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host stand-ins for the peripherals the application links against
+ * but the display scenarios do not use
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include <QMC5883L.hpp>
+#include <lora.hpp>
+
+/* The radio of the stand-in RadioLib accepts every request */
+LoRa::LoRa() : hal{-1, -1, -1}, mod{&hal}, radio{&mod} {}
+
+SX1262* LoRa::getRadio() { return &radio; }
+
+void LoRa::putRadio() {}
+
+esp_err_t QMC5883L::calibrate(uint16_t, uint16_t) { return ESP_ERR_NOT_FOUND; }
+
+esp_err_t QMC5883L::saveCalibration(const char*, const char*) const
+{
+    return ESP_ERR_NOT_SUPPORTED;
+}
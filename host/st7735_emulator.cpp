@@ -0,0 +1,359 @@
+/**
+ * @file st7735_emulator.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host model of the ST7735 panel
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "st7735_emulator.hpp"
+#include "HT_st7735_commands.hpp"
+#include "esp_timer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+st7735_emulator& st7735_emulator::panel()
+{
+    static st7735_emulator panel;
+    return panel;
+}
+
+void st7735_emulator::reset()
+{
+    _col0 = _row0 = 0;
+    _col1 = _row1 = ST7735_EMULATOR_RAM - 1;
+    _col = _row = 0;
+    _ptl0 = 0;
+    _ptl1 = ST7735_GATE_LINES - 1;
+    _colmod = 0x06;
+    _madctl = 0;
+    _gamma = 1;
+    _sleeping = true;
+    _display_on = false;
+    _inverted = false;
+    _idle = false;
+    _partial = false;
+    _cmd = ST7735_NOP;
+    _n_params = 0;
+    _n_pending = 0;
+    _settle_us = esp_timer_get_time();
+}
+
+void st7735_emulator::set_pin(int pin, uint32_t level)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    if (pin == ST7735_CS_Pin)
+    {
+        if (_cs && !level && _powered)
+            _traffic.selects++;
+        _cs = level;
+    }
+    else if (pin == ST7735_DC_Pin)
+    {
+        if (_dc != static_cast<bool>(level))
+            _traffic.dc_toggles++;
+        _dc = level;
+    }
+    else if (pin == ST7735_REST_Pin && !level)
+    {
+        reset();
+    }
+    else if (pin == ST7735_VTFT_CTRL_Pin)
+    {
+        /* Without power the frame memory does not survive */
+        if (!level && _powered)
+        {
+            reset();
+            memset(_ram, 0, sizeof(_ram));
+        }
+        _powered = level;
+    }
+}
+
+void st7735_emulator::hold_pins(bool hold)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    if (hold == _held)
+        return;
+    _held = hold;
+    if (!hold)
+    {
+        _frame_start = _traffic;
+        return;
+    }
+
+    st7735_frame_t frame;
+    frame.traffic = {
+        _traffic.transactions - _frame_start.transactions,
+        _traffic.bytes - _frame_start.bytes,
+        _traffic.commands - _frame_start.commands,
+        _traffic.windows - _frame_start.windows,
+        _traffic.pixels - _frame_start.pixels,
+        _traffic.dc_toggles - _frame_start.dc_toggles,
+        _traffic.selects - _frame_start.selects,
+    };
+    frame.pixels.resize(ST7735_WIDTH * ST7735_HEIGHT);
+    render(frame.pixels.data());
+    _frames.push_back(std::move(frame));
+}
+
+void st7735_emulator::transfer(const uint8_t* data, size_t n)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _traffic.transactions++;
+    _traffic.bytes += n;
+    if (!_dc)
+        _traffic.commands += n;
+    /* A deselected or unpowered panel ignores the bus */
+    if (_cs || !_powered)
+        return;
+    for (size_t i = 0; i < n; i++)
+    {
+        if (!_dc)
+            command(data[i]);
+        else if (_cmd == ST7735_RAMWR)
+            pixel_bytes(data[i]);
+        else
+            parameter(data[i]);
+    }
+}
+
+void st7735_emulator::set_backlight(uint32_t duty, uint32_t max_duty)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    _backlight = max_duty ? (duty * 100 + max_duty / 2) / max_duty : 0;
+}
+
+void st7735_emulator::command(uint8_t cmd)
+{
+    _cmd = cmd;
+    _n_params = 0;
+    _n_pending = 0;
+    switch (cmd)
+    {
+        case ST7735_SWRESET:
+            reset();
+            break;
+        case ST7735_SLPIN:
+        case ST7735_SLPOUT:
+        {
+            const int64_t now = esp_timer_get_time();
+            if (now - _settle_us < ST7735_SLEEP_SETTLE_MS * 1000LL)
+            {
+                fprintf(stderr, "%s %lld us after a reset or sleep change\n",
+                        cmd == ST7735_SLPIN ? "SLPIN" : "SLPOUT",
+                        static_cast<long long>(now - _settle_us));
+                _violations++;
+            }
+            _settle_us = now;
+            _sleeping = cmd == ST7735_SLPIN;
+            break;
+        }
+        case ST7735_PTLON:
+            _partial = true;
+            break;
+        case ST7735_NORON:
+            _partial = false;
+            break;
+        case ST7735_INVOFF:
+            _inverted = false;
+            break;
+        case ST7735_INVON:
+            _inverted = true;
+            break;
+        case ST7735_DISPOFF:
+            _display_on = false;
+            break;
+        case ST7735_DISPON:
+            _display_on = true;
+            break;
+        case ST7735_IDMOFF:
+            _idle = false;
+            break;
+        case ST7735_IDMON:
+            _idle = true;
+            break;
+        case ST7735_CASET:
+        case ST7735_RASET:
+            _traffic.windows++;
+            break;
+        case ST7735_RAMWR:
+            _col = _col0;
+            _row = _row0;
+            break;
+        default:
+            break;
+    }
+}
+
+void st7735_emulator::parameter(uint8_t value)
+{
+    if (_n_params < sizeof(_params))
+        _params[_n_params] = value;
+    _n_params++;
+    const uint16_t first = (_params[0] << 8) | _params[1];
+    const uint16_t last = (_params[2] << 8) | _params[3];
+    switch (_cmd)
+    {
+        case ST7735_CASET:
+            if (_n_params == 4)
+            {
+                _col0 = std::min<uint16_t>(first, ST7735_EMULATOR_RAM - 1);
+                _col1 = std::min<uint16_t>(last, ST7735_EMULATOR_RAM - 1);
+            }
+            break;
+        case ST7735_RASET:
+            if (_n_params == 4)
+            {
+                _row0 = std::min<uint16_t>(first, ST7735_EMULATOR_RAM - 1);
+                _row1 = std::min<uint16_t>(last, ST7735_EMULATOR_RAM - 1);
+            }
+            break;
+        case ST7735_PTLAR:
+            if (_n_params == 4)
+            {
+                _ptl0 = first;
+                _ptl1 = last;
+            }
+            break;
+        case ST7735_COLMOD:
+            if (_n_params == 1)
+                _colmod = value & 0x07;
+            break;
+        case ST7735_MADCTL:
+            if (_n_params == 1)
+                _madctl = value;
+            break;
+        case ST7735_GAMSET:
+            if (_n_params == 1)
+                _gamma = value;
+            break;
+        default:
+            break;
+    }
+}
+
+void st7735_emulator::pixel_bytes(uint8_t value)
+{
+    _pending[_n_pending++] = value;
+    switch (_colmod)
+    {
+        case 0x03: /* 12-bit, two pixels in three bytes */
+            if (_n_pending < 3)
+                return;
+            for (int i = 0; i < 2; i++)
+            {
+                const uint16_t c =
+                    i ? ((_pending[1] & 0x0F) << 8) | _pending[2]
+                      : (_pending[0] << 4) | (_pending[1] >> 4);
+                const uint16_t r = (c >> 8) & 0x0F, g = (c >> 4) & 0x0F,
+                               b = c & 0x0F;
+                write_pixel(((r << 1 | r >> 3) << 11) |
+                            ((g << 2 | g >> 2) << 5) | (b << 1 | b >> 3));
+            }
+            break;
+        case 0x05: /* 16-bit */
+            if (_n_pending < 2)
+                return;
+            write_pixel((_pending[0] << 8) | _pending[1]);
+            break;
+        default: /* 18-bit, six bits at the top of each byte */
+            if (_n_pending < 3)
+                return;
+            write_pixel(((_pending[0] >> 3) << 11) |
+                        ((_pending[1] >> 2) << 5) | (_pending[2] >> 3));
+            break;
+    }
+    _n_pending = 0;
+}
+
+void st7735_emulator::write_pixel(uint16_t rgb565)
+{
+    _ram[_row][_col] = rgb565;
+    _traffic.pixels++;
+    if (++_col > _col1)
+    {
+        _col = _col0;
+        if (++_row > _row1)
+            _row = _row0;
+    }
+}
+
+uint16_t st7735_emulator::gate_line(uint16_t col, uint16_t row) const
+{
+    const uint16_t line = (_madctl & ST7735_MADCTL_MV) ? col : row;
+    return (_madctl & ST7735_MADCTL_MY) ? ST7735_GATE_LINES - 1 - line : line;
+}
+
+uint16_t st7735_emulator::shown(uint16_t col, uint16_t row) const
+{
+    if (!_powered || _sleeping || !_display_on)
+        return ST7735_BLACK;
+    if (_partial)
+    {
+        const uint16_t line = gate_line(col, row);
+        if (line < _ptl0 || line > _ptl1)
+            return ST7735_BLACK;
+    }
+    uint16_t c = _ram[row][col];
+    /* The panel is BGR and shows true colours only with INVON */
+    if (!(_madctl & ST7735_MADCTL_BGR))
+        c = (c & 0x07E0) | (c >> 11) | (c << 11);
+    if (!_inverted)
+        c = ~c;
+    /* Idle mode keeps the MSB of each channel */
+    if (_idle)
+        c = ((c & 0x8000) ? 0xF800 : 0) | ((c & 0x0400) ? 0x07E0 : 0) |
+            ((c & 0x0010) ? 0x001F : 0);
+    return c;
+}
+
+void st7735_emulator::render(uint16_t* pixels) const
+{
+    for (uint16_t y = 0; y < ST7735_HEIGHT; y++)
+        for (uint16_t x = 0; x < ST7735_WIDTH; x++)
+            pixels[y * ST7735_WIDTH + x] =
+                shown(x + ST7735_XSTART, y + ST7735_YSTART);
+}
+
+void st7735_emulator::snapshot(uint16_t* pixels) const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    render(pixels);
+}
+
+bool st7735_emulator::write_ppm(const char* path, const uint16_t* pixels)
+{
+    FILE* f = fopen(path, "wb");
+    if (!f)
+        return false;
+    fprintf(f, "P6\n%u %u\n255\n", ST7735_WIDTH, ST7735_HEIGHT);
+    for (size_t i = 0; i < ST7735_WIDTH * ST7735_HEIGHT; i++)
+    {
+        const uint16_t c = pixels[i];
+        const uint8_t r = c >> 11, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        const uint8_t rgb[3] = {static_cast<uint8_t>(r << 3 | r >> 2),
+                                static_cast<uint8_t>(g << 2 | g >> 4),
+                                static_cast<uint8_t>(b << 3 | b >> 2)};
+        fwrite(rgb, 1, sizeof(rgb), f);
+    }
+    return fclose(f) == 0;
+}
+
+st7735_traffic_t st7735_emulator::traffic() const
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    return _traffic;
+}
+
+std::vector<st7735_frame_t> st7735_emulator::take_frames()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+    std::vector<st7735_frame_t> frames;
+    frames.swap(_frames);
+    return frames;
+}
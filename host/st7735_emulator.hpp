@@ -0,0 +1,139 @@
+/**
+ * @file st7735_emulator.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host model of the ST7735 panel, fed with the bytes the driver
+ * clocks out, and its SPI traffic accounting
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The model decodes the command stream like the controller does: CASET,
+ * RASET and RAMWR write the frame memory in 12, 16 or 18-bit colour (COLMOD),
+ * and the display state commands (SLPIN/SLPOUT, DISPON/DISPOFF,
+ * INVON/INVOFF, IDMON/IDMOFF, PTLON/NORON with PTLAR, GAMSET, MADCTL) change
+ * what a snapshot shows. Addresses are taken in the orientation the driver
+ * sets with MADCTL, so snapshots are in logical coordinates. The panel of the
+ * board is a BGR IPS one, so colours are true with the BGR bit of MADCTL and
+ * INVON set, as the driver's init sequence does. Dropping VTFT powers the
+ * panel off and loses the frame memory.
+ *
+ * Commands that break the datasheet timings, a SLPIN or SLPOUT within
+ * ST7735_SLEEP_SETTLE_MS of a reset or of the previous one, are counted as
+ * violations.
+ *
+ * A frame is everything between the driver releasing and holding the panel
+ * pins, which is how the renderer brackets each of its frames. The traffic
+ * and a snapshot of every frame are kept.
+ */
+
+#pragma once
+
+#include "HT_st7735.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/* The frame memory of the controller, wide enough for either orientation */
+constexpr uint16_t ST7735_EMULATOR_RAM = ST7735_GATE_LINES;
+
+typedef struct
+{
+    uint32_t transactions; /* SPI transactions */
+    uint32_t bytes;        /* Bytes clocked out */
+    uint32_t commands;     /* Bytes sent with DC low */
+    uint32_t windows;      /* CASET and RASET commands */
+    uint32_t pixels;       /* Pixels written through RAMWR */
+    uint32_t dc_toggles;   /* Changes of the DC line */
+    uint32_t selects;      /* Falling edges of CS */
+} st7735_traffic_t;
+
+typedef struct
+{
+    st7735_traffic_t traffic;
+    std::vector<uint16_t> pixels; /* RGB565 snapshot, as seen on the glass */
+} st7735_frame_t;
+
+class st7735_emulator
+{
+public:
+    /** @brief The panel wired to the ST7735 pins of the board */
+    static st7735_emulator& panel();
+
+    /* Driven by the GPIO, SPI and LEDC stand-ins */
+    void set_pin(int pin, uint32_t level);
+    void hold_pins(bool hold);
+    void transfer(const uint8_t* data, size_t n);
+    void set_backlight(uint32_t duty, uint32_t max_duty);
+
+    /**
+     * @brief Render what the panel shows into ST7735_WIDTH * ST7735_HEIGHT
+     * RGB565 pixels, with the display, sleep, idle, partial and inversion
+     * state applied. The backlight is not applied.
+     *
+     * @param pixels
+     */
+    void snapshot(uint16_t* pixels) const;
+
+    /**
+     * @brief Write pixels from snapshot() as a binary PPM image.
+     *
+     * @return true on success
+     */
+    static bool write_ppm(const char* path, const uint16_t* pixels);
+
+    /** @brief Traffic since the start of the run */
+    st7735_traffic_t traffic() const;
+
+    /** @brief The frames completed since the last call, oldest first */
+    std::vector<st7735_frame_t> take_frames();
+
+    uint8_t backlight() const { return _backlight; }
+    bool display_on() const { return _display_on && !_sleeping; }
+    uint8_t gamma() const { return _gamma; }
+    uint32_t violations() const { return _violations; }
+
+private:
+    void reset();
+    void command(uint8_t cmd);
+    void parameter(uint8_t value);
+    void pixel_bytes(uint8_t value);
+    void write_pixel(uint16_t rgb565);
+    uint16_t gate_line(uint16_t col, uint16_t row) const;
+    uint16_t shown(uint16_t col, uint16_t row) const;
+    void render(uint16_t* pixels) const;
+
+    mutable std::mutex _lock;
+    /* Panel state */
+    uint16_t _ram[ST7735_EMULATOR_RAM][ST7735_EMULATOR_RAM] = {};
+    uint16_t _col0 = 0, _col1 = 0, _row0 = 0, _row1 = 0; /* Window */
+    uint16_t _col = 0, _row = 0; /* Next RAMWR position */
+    uint16_t _ptl0 = 0, _ptl1 = ST7735_GATE_LINES - 1;
+    uint8_t _colmod = 0x06;
+    uint8_t _madctl = 0;
+    uint8_t _gamma = 1;
+    bool _sleeping = true;
+    bool _display_on = false;
+    bool _inverted = false;
+    bool _idle = false;
+    bool _partial = false;
+    uint8_t _backlight = 0; /* % */
+    /* Decoder state */
+    uint8_t _cmd = 0;
+    uint8_t _params[4] = {};
+    size_t _n_params = 0;
+    uint8_t _pending[3] = {}; /* Bytes of an incomplete pixel group */
+    size_t _n_pending = 0;
+    /* Lines */
+    bool _cs = true;
+    bool _dc = true;
+    bool _held = true; /* Until the first frame, init() is not in one */
+    bool _powered = true;
+    int64_t _settle_us = 0; /* Last reset, SLPIN or SLPOUT */
+    uint32_t _violations = 0;
+    /* Accounting */
+    st7735_traffic_t _traffic = {};
+    st7735_traffic_t _frame_start = {};
+    std::vector<st7735_frame_t> _frames;
+};
@@ -0,0 +1,513 @@
+/**
+ * @file st7735_host.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Replays display scenarios of the application against the ST7735
+ * emulator, to catch screen changes and SPI cost regressions on the host
+ * @version 0.1
+ * @date 2025-07-30
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Usage: st7735_host [-v] [-n] [-4] [-o dir] [-r dir] [-b baseline.csv] [-u]
+ *   -v  log the application at INFO level
+ *   -n  run without the shadow framebuffer, the text layer goes out in bands
+ *       straight from the line buffer
+ *   -4  send the pixels in RGB444
+ *   -o  write every frame as <dir>/<step>-<n>.ppm, and a <step>-<n>-diff.ppm
+ *       for every frame that differs from the reference
+ *   -r  compare every frame with <dir>/<step>-<n>.ppm, e.g. the -o output of
+ *       an earlier build
+ *   -b  compare the traffic and the screens of every step with a baseline,
+ *       fail if any of them got more expensive or looks different
+ *   -u  write the baseline instead of checking it
+ *
+ * The application runs on a virtual clock, so a run is deterministic.
+ */
+
+#include "Astrolavos.hpp"
+#include "HT_st7735_renderer.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "st7735_emulator.hpp"
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+typedef struct
+{
+    const char* name;
+    std::function<void()> run;
+    std::function<bool()> check; /* Of the panel after the step, if set */
+} scenario_step_t;
+
+typedef struct
+{
+    std::string name;
+    uint32_t frames;
+    st7735_traffic_t traffic; /* All the traffic of the step */
+    uint32_t hash;            /* Of the screens of all its frames */
+    uint8_t backlight;        /* % at the end of the step */
+} step_result_t;
+
+static const char* const traffic_columns[] = {
+    "transactions", "bytes", "commands", "windows",
+    "pixels",       "dc_toggles", "selects"};
+constexpr size_t TRAFFIC_COLUMNS =
+    sizeof(traffic_columns) / sizeof(traffic_columns[0]);
+static_assert(sizeof(st7735_traffic_t) == TRAFFIC_COLUMNS * sizeof(uint32_t),
+              "a column per counter");
+
+static HT_st7735 display;
+static HT_st7735_renderer renderer;
+static astrolavos::Astrolavos app;
+static LoRa lora;
+static bool use_framebuffer = true;
+static st7735_pixel_format_t pixel_format = ST7735_PIXEL_RGB565;
+
+/* The counters of st7735_traffic_t in the order of traffic_columns */
+static uint32_t* counters(st7735_traffic_t& t)
+{
+    return reinterpret_cast<uint32_t*>(&t);
+}
+
+static const uint32_t* counters(const st7735_traffic_t& t)
+{
+    return reinterpret_cast<const uint32_t*>(&t);
+}
+
+static uint32_t fnv1a(uint32_t hash, const void* data, size_t n)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < n; i++)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+static bool read_ppm(const char* path, std::vector<uint16_t>& pixels)
+{
+    FILE* f = fopen(path, "rb");
+    if (!f)
+        return false;
+    unsigned w, h, max;
+    bool ok = fscanf(f, "P6 %u %u %u", &w, &h, &max) == 3 &&
+              w == ST7735_WIDTH && h == ST7735_HEIGHT && max == 255 &&
+              fgetc(f) != EOF;
+    pixels.resize(ST7735_WIDTH * ST7735_HEIGHT);
+    for (size_t i = 0; ok && i < pixels.size(); i++)
+    {
+        uint8_t rgb[3];
+        ok = fread(rgb, 1, sizeof(rgb), f) == sizeof(rgb);
+        pixels[i] =
+            ((rgb[0] >> 3) << 11) | ((rgb[1] >> 2) << 5) | (rgb[2] >> 3);
+    }
+    fclose(f);
+    return ok;
+}
+
+/**
+ * @brief Compare a frame with its reference. The differing pixels are
+ * written in magenta over a darkened reference when diff_path is set.
+ *
+ * @return the number of pixels that differ, or -1 without a reference
+ */
+static int diff_frame(const std::vector<uint16_t>& pixels, const char* ref_path,
+                      const char* diff_path)
+{
+    std::vector<uint16_t> ref;
+    if (!read_ppm(ref_path, ref))
+        return -1;
+    int n = 0;
+    std::vector<uint16_t> diff(pixels.size());
+    for (size_t i = 0; i < pixels.size(); i++)
+    {
+        if (pixels[i] != ref[i])
+        {
+            n++;
+            diff[i] = ST7735_MAGENTA;
+        }
+        else
+        {
+            diff[i] = (ref[i] >> 2) & 0x39E7; /* A quarter of each channel */
+        }
+    }
+    if (n && diff_path)
+        st7735_emulator::write_ppm(diff_path, diff.data());
+    return n;
+}
+
+/* One pass of the loop of astrolavos_task */
+static void app_cycle()
+{
+    if (app.isIsolationModeTriggered())
+        app.updateIsolationMode();
+    if (app.isIWMTTriggered())
+        app.updateIWantToMeet();
+    const astrolavos::display_profile_t profile = app.updateDisplayProfile();
+    const bool backlight = app.updateBacklight(profile);
+    if (profile != astrolavos::ASTROLAVOS_DISPLAY_OFF &&
+        !app.refreshChangedWidgets(profile) && backlight)
+        app.renderScreen();
+}
+
+/* Wait for the render task to take everything posted so far. Only the
+ * application closes frames, so that one it forgot shows up as commands
+ * left without a frame, which the device would not send either */
+static size_t settle()
+{
+    /* The change notifications of Astrolavos share the task notification
+     * with sync() */
+    ulTaskNotifyTake(pdTRUE, 0);
+    return renderer.sync();
+}
+
+static void update_peer(int id, int32_t latitude, int32_t longitude,
+                        bool wants_to_meet = false)
+{
+    astrolavos::device_data_t data = {};
+    data.coordinates = {latitude, longitude, 0};
+    data.wants_to_meet = wants_to_meet;
+    app.updateDevice(id, data);
+}
+
+/* Our position and the offsets of the peers are in 1e-7 degrees */
+static constexpr int32_t HOME_LATITUDE = 379715000;
+static constexpr int32_t HOME_LONGITUDE = 237257000;
+
+static const scenario_step_t scenario[] = {
+    {"init",
+     []
+     {
+         display.init();
+         display.set_backlight(80);
+         if (use_framebuffer)
+             display.enable_framebuffer();
+         display.set_pixel_format(pixel_format);
+         ESP_ERROR_CHECK(renderer.init(&display));
+         xTaskCreate(display_render_task, "display_render_task", 4096,
+                     &renderer, 5, NULL);
+     }},
+    {"splash", [] { app.init(&renderer, &lora); }},
+    {"first-fix",
+     []
+     {
+         app.updateHealthBattery(87);
+         app.updateHealthGNSS(9);
+         app.updateHealthMagnetometer(astrolavos::MAGNETOMETER_HEALTHY);
+         app.updateHeading(42.0f);
+         app.updateCoordinates({HOME_LATITUDE, HOME_LONGITUDE, 0});
+         app_cycle();
+     }},
+    {"peers",
+     []
+     {
+         update_peer(1, HOME_LATITUDE + 20000, HOME_LONGITUDE);
+         update_peer(2, HOME_LATITUDE + 10000, HOME_LONGITUDE + 15000);
+         update_peer(3, HOME_LATITUDE - 30000, HOME_LONGITUDE - 10000);
+         /* More peers than the list has rows */
+         for (int id = 4; id < ASTROLAVOS_NUMBER_OF_DEVICES; id++)
+             update_peer(id, HOME_LATITUDE + 4000 * id,
+                         HOME_LONGITUDE - 5000 * id);
+         app_cycle();
+     }},
+    {"scroll",
+     []
+     {
+         host_clock_advance(ASTROLAVOS_PEER_SCROLL_PERIOD * 1000LL);
+         app_cycle();
+     }},
+    {"peer-moves",
+     []
+     {
+         update_peer(2, HOME_LATITUDE + 12000, HOME_LONGITUDE + 15000);
+         app_cycle();
+     }},
+    {"heading",
+     []
+     {
+         app.updateHeading(130.0f);
+         app_cycle();
+     }},
+    {"idle", [] { app_cycle(); }},
+    {"iwtm",
+     []
+     {
+         app.triggerIWTM();
+         update_peer(3, HOME_LATITUDE - 30000, HOME_LONGITUDE - 10000,
+                     true);
+         app_cycle();
+     }},
+    {"dim",
+     []
+     {
+         host_clock_advance(31 * 1000000LL);
+         app_cycle();
+     }},
+    {"stale",
+     []
+     {
+         host_clock_advance(5 * 60 * 1000000LL);
+         app_cycle();
+     }},
+    {"isolation",
+     []
+     {
+         app.triggerIsolationMode();
+         app_cycle();
+     },
+     []
+     {
+         const st7735_emulator& panel = st7735_emulator::panel();
+         return !panel.display_on() && !panel.backlight();
+     }},
+    {"while-off",
+     []
+     {
+         update_peer(1, HOME_LATITUDE + 21000, HOME_LONGITUDE);
+         host_clock_advance(20 * 1000000LL);
+         app_cycle();
+     },
+     [] { return !st7735_emulator::panel().display_on(); }},
+    {"wake",
+     []
+     {
+         app.triggerIsolationMode();
+         app_cycle();
+     },
+     [] { return st7735_emulator::panel().display_on(); }},
+    {"glance",
+     []
+     {
+         app.updateHealthBattery(10);
+         app_cycle();
+     }},
+};
+
+static step_result_t run_step(const scenario_step_t& step, const char* out_dir,
+                              const char* ref_dir, int& failures)
+{
+    st7735_emulator& panel = st7735_emulator::panel();
+    const st7735_traffic_t before = panel.traffic();
+    step.run();
+    const size_t unframed = settle();
+    if (unframed)
+    {
+        printf("%s: %zu command(s) left without a frame\n", step.name,
+               unframed);
+        failures++;
+    }
+    if (step.check && !step.check())
+    {
+        printf("%s: the panel is not in the expected state\n", step.name);
+        failures++;
+    }
+    const st7735_traffic_t after = panel.traffic();
+    std::vector<st7735_frame_t> frames = panel.take_frames();
+
+    step_result_t result = {step.name, static_cast<uint32_t>(frames.size()),
+                            {}, 2166136261u, panel.backlight()};
+    uint32_t* traffic = counters(result.traffic);
+    for (size_t i = 0; i < TRAFFIC_COLUMNS; i++)
+        traffic[i] = counters(after)[i] - counters(before)[i];
+
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        const std::vector<uint16_t>& pixels = frames[i].pixels;
+        result.hash = fnv1a(result.hash, pixels.data(),
+                            pixels.size() * sizeof(pixels[0]));
+        char name[64], path[512], diff_path[512];
+        snprintf(name, sizeof(name), "%s-%zu", step.name, i);
+        if (out_dir)
+        {
+            snprintf(path, sizeof(path), "%s/%s.ppm", out_dir, name);
+            if (!st7735_emulator::write_ppm(path, pixels.data()))
+                fprintf(stderr, "Cannot write %s\n", path);
+        }
+        if (ref_dir)
+        {
+            snprintf(path, sizeof(path), "%s/%s.ppm", ref_dir, name);
+            snprintf(diff_path, sizeof(diff_path), "%s/%s-diff.ppm",
+                     out_dir ? out_dir : "", name);
+            const int n =
+                diff_frame(pixels, path, out_dir ? diff_path : nullptr);
+            if (n < 0)
+                printf("  %s: no reference\n", name);
+            else if (n > 0)
+            {
+                printf("  %s: %d pixels differ\n", name, n);
+                failures++;
+            }
+        }
+    }
+    return result;
+}
+
+static void print_result(const step_result_t& r)
+{
+    printf("%-12s %6lu", r.name.c_str(), static_cast<unsigned long>(r.frames));
+    for (size_t i = 0; i < TRAFFIC_COLUMNS; i++)
+        printf(" %12lu", static_cast<unsigned long>(counters(r.traffic)[i]));
+    printf(" %08lx %3u%%\n", static_cast<unsigned long>(r.hash), r.backlight);
+}
+
+static bool write_baseline(const char* path,
+                           const std::vector<step_result_t>& results)
+{
+    FILE* f = fopen(path, "w");
+    if (!f)
+        return false;
+    fprintf(f, "step,frames");
+    for (const char* column : traffic_columns)
+        fprintf(f, ",%s", column);
+    fprintf(f, ",hash\n");
+    for (const step_result_t& r : results)
+    {
+        fprintf(f, "%s,%lu", r.name.c_str(),
+                static_cast<unsigned long>(r.frames));
+        for (size_t i = 0; i < TRAFFIC_COLUMNS; i++)
+            fprintf(f, ",%lu",
+                    static_cast<unsigned long>(counters(r.traffic)[i]));
+        fprintf(f, ",%08lx\n", static_cast<unsigned long>(r.hash));
+    }
+    return fclose(f) == 0;
+}
+
+/* Costs only ever count against a step when they grow */
+static int check_baseline(const char* path,
+                          const std::vector<step_result_t>& results)
+{
+    FILE* f = fopen(path, "r");
+    if (!f)
+    {
+        fprintf(stderr, "Cannot read %s\n", path);
+        return 1;
+    }
+    std::map<std::string, step_result_t> baseline;
+    char line[512];
+    fgets(line, sizeof(line), f); /* Header */
+    while (fgets(line, sizeof(line), f))
+    {
+        step_result_t r = {};
+        uint32_t* traffic = counters(r.traffic);
+        char* field = strtok(line, ",\n");
+        if (!field)
+            continue;
+        r.name = field;
+        r.frames = strtoul(strtok(nullptr, ",\n"), nullptr, 10);
+        for (size_t i = 0; i < TRAFFIC_COLUMNS; i++)
+            traffic[i] = strtoul(strtok(nullptr, ",\n"), nullptr, 10);
+        r.hash = strtoul(strtok(nullptr, ",\n"), nullptr, 16);
+        baseline[r.name] = r;
+    }
+    fclose(f);
+
+    int failures = 0;
+    for (const step_result_t& r : results)
+    {
+        auto it = baseline.find(r.name);
+        if (it == baseline.end())
+        {
+            printf("%s: not in the baseline\n", r.name.c_str());
+            continue;
+        }
+        const step_result_t& b = it->second;
+        for (size_t i = 0; i < TRAFFIC_COLUMNS; i++)
+        {
+            const uint32_t now = counters(r.traffic)[i];
+            const uint32_t was = counters(b.traffic)[i];
+            if (now == was)
+                continue;
+            printf("%s: %s %lu -> %lu%s\n", r.name.c_str(),
+                   traffic_columns[i], static_cast<unsigned long>(was),
+                   static_cast<unsigned long>(now),
+                   now > was ? " REGRESSION" : "");
+            failures += now > was;
+        }
+        if (r.hash != b.hash)
+        {
+            printf("%s: the screen changed, see -o and -r\n",
+                   r.name.c_str());
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main(int argc, char** argv)
+{
+    const char* out_dir = nullptr;
+    const char* ref_dir = nullptr;
+    const char* baseline = nullptr;
+    bool update = false;
+    int opt;
+    while ((opt = getopt(argc, argv, "vn4o:r:b:u")) != -1)
+    {
+        switch (opt)
+        {
+            case 'v':
+                host_log_level = ESP_LOG_INFO;
+                break;
+            case 'n':
+                use_framebuffer = false;
+                break;
+            case '4':
+                pixel_format = ST7735_PIXEL_RGB444;
+                break;
+            case 'o':
+                out_dir = optarg;
+                break;
+            case 'r':
+                ref_dir = optarg;
+                break;
+            case 'b':
+                baseline = optarg;
+                break;
+            case 'u':
+                update = true;
+                break;
+            default:
+                fprintf(stderr,
+                        "Usage: %s [-v] [-n] [-4] [-o dir] [-r dir] "
+                        "[-b baseline.csv] [-u]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+
+    int failures = 0;
+    std::vector<step_result_t> results;
+    printf("%-12s %6s", "step", "frames");
+    for (const char* column : traffic_columns)
+        printf(" %12s", column);
+    printf(" %8s %4s\n", "hash", "bl");
+    for (const scenario_step_t& step : scenario)
+    {
+        results.push_back(run_step(step, out_dir, ref_dir, failures));
+        print_result(results.back());
+    }
+
+    if (baseline && update)
+    {
+        if (!write_baseline(baseline, results))
+        {
+            fprintf(stderr, "Cannot write %s\n", baseline);
+            return 1;
+        }
+    }
+    else if (baseline)
+    {
+        failures += check_baseline(baseline, results);
+    }
+    if (st7735_emulator::panel().violations())
+    {
+        printf("%u datasheet timing violation(s)\n",
+               st7735_emulator::panel().violations());
+        failures++;
+    }
+    if (failures)
+        printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -19,6 +19,7 @@
 #include "freertos/task.h"
 #include <HT_st7735_fonts.hpp>
 #include <TinyGPS++.hpp>
+#include <algorithm>
 #include <cmath>
 #include <pins.hpp>
 #include <utils.hpp>
@@ -30,13 +31,30 @@ namespace astrolavos
 extern paired_device_auto_config_t
     paired_device_auto_config[ASTROLAVOS_NUMBER_OF_DEVICES];
 extern paired_device_auto_config_t this_device;
+extern const st7735_image_t astrolavos_splash;
 
 constexpr size_t ASTROLAVOS_WELCOME_SLEEP = 3 * 1000;
-
-constexpr float EARTH_RADIUS_M = 6371000.0f; // Radius of the Earth in meters
+/* Palette entry of the splash emblem that takes the device colour */
+constexpr uint8_t ASTROLAVOS_SPLASH_DEVICE_COLOUR = 1;
+constexpr uint16_t ASTROLAVOS_SPLASH_X = 4;
+constexpr uint16_t ASTROLAVOS_SPLASH_TEXT_X = 46;
 
 constexpr float ASTROLAVOS_MAXIMUM_ACCEPTABLE_DISTANCE = 10000; /* 10km */
 
+/* Brightening answers the user, dimming should go unnoticed */
+constexpr uint16_t ASTROLAVOS_BACKLIGHT_BRIGHTEN_MS = 200;
+constexpr uint16_t ASTROLAVOS_BACKLIGHT_DIM_MS = 2000;
+constexpr int64_t ASTROLAVOS_BACKLIGHT_REPORT_PERIOD =
+    10 * 60 * 1000 * 1000LL; /* 10 minutes in us */
+/* The battery has to recover this much above the threshold to leave glance */
+constexpr uint8_t ASTROLAVOS_GLANCE_BATTERY_HYSTERESIS = 5;
+/* Width of the glance strip in text cells, the panel drives only this band */
+constexpr uint8_t ASTROLAVOS_GLANCE_COLUMNS = 7;
+/* Rows of the peer list, above our IWTM row and the health bar */
+constexpr int ASTROLAVOS_PEER_ROWS = ST7735_TEXT_ROWS - 2;
+/* Columns left of the radar, its range is written there */
+constexpr uint8_t ASTROLAVOS_RADAR_LABEL_COLUMNS = 7;
+
 const sleep_duration_t normal_sleep_duration = {
     .heading = 1000,          /* 1 second */
     .main_app_refresh = 2000, /* 2 seconds */
@@ -70,13 +88,19 @@ void Astrolavos::updateHealthBattery(uint8_t percentage)
         percentage = BATTERY_STATUS_UNKNOWN;
     }
     assert(xSemaphoreTake(_health_mutex, portMAX_DELAY) == pdTRUE);
+    const bool changed = _healthStatus.battery.percentage != percentage;
+    if (changed)
+        _health_generation++;
     _healthStatus.battery.percentage = percentage;
     _healthStatus.battery.ts = esp_timer_get_time();
     assert(xSemaphoreGive(_health_mutex) == pdTRUE);
+    if (changed)
+        notifyChange();
 }
 
 void Astrolavos::updateHealthGNSS(uint8_t num_satellites)
 {
+    bool changed = false;
     xSemaphoreTake(_health_mutex, portMAX_DELAY);
     if (num_satellites > 96 &&
         num_satellites != GNSS_NO_SATELLITES) /* Max Number of Satellites
@@ -85,19 +109,28 @@ void Astrolavos::updateHealthGNSS(uint8_t num_satellites)
         ESP_LOGE(TAG, "Invalid number of satellites: %d", num_satellites);
         num_satellites = GNSS_NO_SATELLITES; // Set to no satellites if invalid
     }
-    else
+    else if (_healthStatus.gnss.num_satellites != num_satellites)
     {
         _healthStatus.gnss.num_satellites = num_satellites;
+        changed = true;
+        _health_generation++;
     }
     _healthStatus.gnss.ts = esp_timer_get_time();
     xSemaphoreGive(_health_mutex);
+    if (changed)
+        notifyChange();
 }
 void Astrolavos::updateHealthMagnetometer(magnetometer_health_t status)
 {
     xSemaphoreTake(_health_mutex, portMAX_DELAY);
+    const bool changed = _healthStatus.magnetometer.status != status;
+    if (changed)
+        _health_generation++;
     _healthStatus.magnetometer.status = status;
     _healthStatus.magnetometer.ts = esp_timer_get_time();
     xSemaphoreGive(_health_mutex);
+    if (changed)
+        notifyChange();
 }
 
 int Astrolavos::updateDevice(int id, const device_data_t& data)
@@ -115,7 +148,10 @@ int Astrolavos::updateDevice(int id, const device_data_t& data)
         return ESP_ERR_NOT_FOUND;
     }
 
+    const uint32_t generation = device->getGeneration();
     device->updateDevice(data);
+    if (device->getGeneration() != generation)
+        notifyChange();
     return ESP_OK;
 }
 
@@ -126,21 +162,63 @@ void Astrolavos::updateHeading(float heading)
         ESP_LOGE(TAG, "Invalid heading: %f", heading);
         return;
     }
+    /* The screen shows whole degrees */
+    const bool changed = std::isnan(_heading.heading) ||
+                         static_cast<int>(heading) !=
+                             static_cast<int>(_heading.heading);
     _heading.heading = heading;
     _heading.ts = esp_timer_get_time();
+    if (changed)
+    {
+        _heading_generation++;
+        notifyChange();
+    }
+}
+
+void Astrolavos::updateTime(uint8_t hour, uint8_t minute)
+{
+    /* The GNSS time is kept with the rest of the GNSS health */
+    xSemaphoreTake(_health_mutex, portMAX_DELAY);
+    _backlight.updateTime(hour, minute, esp_timer_get_time());
+    xSemaphoreGive(_health_mutex);
 }
 
 void Astrolavos::updateCoordinates(const gnss_location_t& coordinates)
 {
+    /* The terms are computed outside of the lock, the readers only wait for
+     * the copy */
+    const geodesy_origin_t origin =
+        geodesyOrigin(coordinates.latitude, coordinates.longitude);
+    xSemaphoreTake(_position_mutex, portMAX_DELAY);
+    const bool changed = coordinates.latitude != _coordinates.latitude ||
+                         coordinates.longitude != _coordinates.longitude;
     _coordinates.latitude = coordinates.latitude;
     _coordinates.longitude = coordinates.longitude;
     _coordinates.ts = coordinates.ts;
+    if (changed)
+    {
+        _origin = origin;
+        _coordinates_generation++;
+    }
+    xSemaphoreGive(_position_mutex);
 
-    ESP_LOGI(TAG, "Updated coordinates: Lat: %f, Lon: %f",
-             _coordinates.latitude, _coordinates.longitude);
+    ESP_LOGI(TAG, "Updated coordinates: Lat: %ld, Lon: %ld (1e-7 deg)",
+             static_cast<long>(coordinates.latitude),
+             static_cast<long>(coordinates.longitude));
+    if (changed)
+        notifyChange();
 }
 
-esp_err_t Astrolavos::calculateHeading(int id, float& heading)
+uint32_t Astrolavos::getOrigin(geodesy_origin_t& origin)
+{
+    xSemaphoreTake(_position_mutex, portMAX_DELAY);
+    const uint32_t generation = _coordinates_generation;
+    origin = _origin;
+    xSemaphoreGive(_position_mutex);
+    return generation;
+}
+
+esp_err_t Astrolavos::calculateVector(int id, geodesy_vector_t& vector)
 {
     if (id < 0 || id >= ASTROLAVOS_NUMBER_OF_DEVICES)
     {
@@ -156,152 +234,50 @@ esp_err_t Astrolavos::calculateHeading(int id, float& heading)
     }
 
     gnss_location_t target = device->getCoordinates();
-    if (target.latitude == std::nanf("No Latitude") ||
-        target.longitude == std::nanf("No Longitude"))
+    if (target.latitude == ASTROLAVOS_COORDINATE_UNKNOWN ||
+        target.longitude == ASTROLAVOS_COORDINATE_UNKNOWN)
     {
         return ESP_ERR_INVALID_ARG;
     }
+    geodesy_origin_t origin;
+    const uint32_t generation = getOrigin(origin);
+    if (origin.latitude == ASTROLAVOS_COORDINATE_UNKNOWN ||
+        origin.longitude == ASTROLAVOS_COORDINATE_UNKNOWN)
+        return ESP_ERR_INVALID_STATE;
 
-    float lat1 = _coordinates.latitude * DEG_TO_RAD;
-    float lat2 = target.latitude * DEG_TO_RAD;
-    float dLon = (target.longitude - _coordinates.longitude) * DEG_TO_RAD;
-
-    float y = sin(dLon) * cos(lat2);
-    float x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dLon);
-
-    float headingRad = atan2(y, x);
-    float headingDeg = headingRad * RAD_TO_DEG;
-
-    heading = fmodf((headingDeg + 360.0f), 360.0f);
-
+    vector = device->getVector(origin, generation);
     return ESP_OK;
 }
 
-direction_t Astrolavos::calculateDirectionQuart(float target_heading)
+esp_err_t Astrolavos::calculateHeading(int id, float& heading)
 {
-    float relativeHeading = target_heading - _heading.heading;
-
-    while (relativeHeading < 0)
-    {
-        relativeHeading += 360.0f;
-    }
-    while (relativeHeading >= 360.0f)
-    {
-        relativeHeading -= 360.0f;
-    }
-
-    if (relativeHeading >= 337.5f || relativeHeading < 22.5f)
-    {
-        return ASTROLAVOS_DIRECTION_FRONT;
-    }
-    else if (relativeHeading >= 22.5f && relativeHeading < 67.5f)
-    {
-        return ASTROLAVOS_DIRECTION_FRONT_RIGHT;
-    }
-    else if (relativeHeading >= 67.5f && relativeHeading < 112.5f)
-    {
-        return ASTROLAVOS_DIRECTION_RIGHT;
-    }
-    else if (relativeHeading >= 112.5f && relativeHeading < 157.5f)
-    {
-        return ASTROLAVOS_DIRECTION_BACK_RIGHT;
-    }
-    else if (relativeHeading >= 157.5f && relativeHeading < 202.5f)
-    {
-        return ASTROLAVOS_DIRECTION_BACK;
-    }
-    else if (relativeHeading >= 202.5f && relativeHeading < 247.5f)
-    {
-        return ASTROLAVOS_DIRECTION_BACK_LEFT;
-    }
-    else if (relativeHeading >= 247.5f && relativeHeading < 292.5f)
-    {
-        return ASTROLAVOS_DIRECTION_LEFT;
-    }
-    else if (relativeHeading >= 292.5f && relativeHeading < 337.5f)
-    {
-        return ASTROLAVOS_DIRECTION_FRONT_LEFT;
-    }
-    else
-    {
-        return ASTROLAVOS_DIRECTION_UNKNOWN;
-    }
+    geodesy_vector_t vector;
+    esp_err_t err = calculateVector(id, vector);
+    if (err != ESP_OK)
+        return err;
+    heading = vector.bearing / 100.0f;
+    return ESP_OK;
 }
 
-void Astrolavos::printDirection(direction_t direction, char buf[3])
+esp_err_t Astrolavos::calculateArrow(float target_heading, uint8_t& arrow)
 {
-    switch (direction)
-    {
-        case ASTROLAVOS_DIRECTION_FRONT:
-            snprintf(buf, 3, "F");
-            break;
-        case ASTROLAVOS_DIRECTION_FRONT_RIGHT:
-            snprintf(buf, 3, "FR");
-            break;
-        case ASTROLAVOS_DIRECTION_RIGHT:
-            snprintf(buf, 3, "R");
-            break;
-        case ASTROLAVOS_DIRECTION_BACK_RIGHT:
-            snprintf(buf, 3, "BR");
-            break;
-        case ASTROLAVOS_DIRECTION_BACK:
-            snprintf(buf, 3, "B");
-            break;
-        case ASTROLAVOS_DIRECTION_BACK_LEFT:
-            snprintf(buf, 3, "BL");
-            break;
-        case ASTROLAVOS_DIRECTION_LEFT:
-            snprintf(buf, 3, "L");
-            break;
-        case ASTROLAVOS_DIRECTION_FRONT_LEFT:
-            snprintf(buf, 3, "FL");
-            break;
-        default:
-            snprintf(buf, 3, "?");
-            break;
-    }
+    if (std::isnan(_heading.heading) || std::isnan(target_heading))
+        return ESP_ERR_INVALID_STATE;
+    float relative = fmodf(target_heading - _heading.heading + 360.0f, 360.0f);
+    constexpr float step = 360.0f / ST7735_ARROW_COUNT;
+    arrow = static_cast<uint8_t>(lroundf(relative / step)) % ST7735_ARROW_COUNT;
+    return ESP_OK;
 }
 
 esp_err_t Astrolavos::calculateDistance(int id, float& distance)
 {
-    if (id < 0 || id >= ASTROLAVOS_NUMBER_OF_DEVICES)
-    {
-        ESP_LOGE(TAG, "Invalid device ID: %d", id);
-        return ESP_ERR_INVALID_ARG;
-    }
-    AstrolavosPairedDevice* device = getDevice(id);
-    if (!device)
-    {
-        ESP_LOGE(TAG, "Device with ID %d not found", id);
-        return ESP_ERR_NOT_FOUND;
-    }
-    gnss_location_t target = device->getCoordinates();
-    if (std::isnan(target.latitude) || std::isnan(target.longitude))
-    {
-        return ESP_ERR_INVALID_ARG;
-    }
-
-    if (std::isnan(_coordinates.latitude) || std::isnan(_coordinates.longitude))
-    {
+    geodesy_vector_t vector;
+    esp_err_t err = calculateVector(id, vector);
+    if (err == ESP_ERR_INVALID_STATE)
         ESP_LOGE(TAG, "Astrolavos coordinates not set");
-        return ESP_ERR_INVALID_STATE;
-    }
-
-    /* Haversine Calculation of distance */
-    float lat1 = _coordinates.latitude * DEG_TO_RAD;
-    float lat2 = target.latitude * DEG_TO_RAD;
-    float lon1 = _coordinates.longitude * DEG_TO_RAD;
-    float lon2 = target.longitude * DEG_TO_RAD;
-    float dLat = lat2 - lat1;
-    float dLon = lon2 - lon1;
-
-    float sinDLat = sin(dLat / 2.0f);
-    float sinDLon = sin(dLon / 2.0f);
-
-    float a_hav = sinDLat * sinDLat + cos(lat1) * cos(lat2) * sinDLon * sinDLon;
-
-    float c = 2.0f * atan2(sqrt(a_hav), sqrt(1.0f - a_hav));
-    distance = EARTH_RADIUS_M * c;
+    if (err != ESP_OK)
+        return err;
+    distance = vector.distance / 100.0f;
     if (distance > ASTROLAVOS_MAXIMUM_ACCEPTABLE_DISTANCE)
         return ESP_FAIL;
     return ESP_OK;
@@ -321,6 +297,7 @@ void Astrolavos::initialisePairedDevices()
             device.configure(paired_device_auto_config[i].id,
                              paired_device_auto_config[i].colour,
                              paired_device_auto_config[i].name);
+            _n_peers++;
             ESP_LOGI(TAG, "Device %d configured: %s", i, device.getName());
         }
         else
@@ -353,13 +330,47 @@ AstrolavosPairedDevice* Astrolavos::getDevice(int id)
     return nullptr;
 }
 
-gnss_location_t Astrolavos::getCoordinates() { return _coordinates; }
+gnss_location_t Astrolavos::getCoordinates()
+{
+    xSemaphoreTake(_position_mutex, portMAX_DELAY);
+    const gnss_location_t coordinates = _coordinates;
+    xSemaphoreGive(_position_mutex);
+    return coordinates;
+}
 
 int Astrolavos::getId() { return _id; }
 
-void Astrolavos::triggerIsolationMode() { _isolation_mode_triggered = true; }
+void Astrolavos::triggerIsolationMode()
+{
+    _isolation_mode_triggered = true;
+    notifyChangeFromISR();
+}
+
+void Astrolavos::triggerIWTM()
+{
+    _i_want_to_meet_mode_triggered = true;
+    notifyChangeFromISR();
+}
+
+void Astrolavos::notifyChange()
+{
+    if (_task)
+        xTaskNotifyGive(_task);
+}
+
+void Astrolavos::notifyChangeFromISR()
+{
+    if (!_task)
+        return;
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(_task, &woken);
+    portYIELD_FROM_ISR(woken);
+}
 
-void Astrolavos::triggerIWTM() { _i_want_to_meet_mode_triggered = true; }
+void Astrolavos::waitForChange(uint32_t timeout_ms)
+{
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeout_ms));
+}
 
 bool Astrolavos::isIsolationModeTriggered()
 {
@@ -372,12 +383,12 @@ void Astrolavos::updateIsolationMode()
 {
     _isolation_mode_triggered = false;
     _isolation_mode = !_isolation_mode;
+    _backlight.activity(esp_timer_get_time());
     if (_isolation_mode)
     {
         _sleep_duration = &isolation_sleep;
         _lora->getRadio()->sleep();
         _lora->putRadio();
-        _display->turn_off();
     }
     else
     {
@@ -390,7 +401,6 @@ void Astrolavos::updateIsolationMode()
         else if (radio->startReceive() != RADIOLIB_ERR_NONE)
             ESP_LOGE(TAG, "Failed to start RX after isolation mode is off");
         _lora->putRadio();
-        _display->turn_on();
     }
     gpio_intr_enable(heltec::PIN_USR_SWITCH);
 }
@@ -401,6 +411,8 @@ void Astrolavos::updateIWantToMeet()
 {
     _i_want_to_meet_mode_triggered = false;
     _i_want_to_meet = !_i_want_to_meet;
+    _iwtm_generation++;
+    _backlight.activity(esp_timer_get_time());
     gpio_intr_enable(heltec::PIN_IWTM_SWITCH);
 }
 
@@ -414,47 +426,51 @@ void Astrolavos::setupMode()
 {
     esp_err_t err;
     ESP_LOGI(TAG, "Entering Setup Mode");
-    _display->unhold_pins();
-    _display->fill_rectangle(0, 0, 160, Font_11x18.height, _color);
-    _display->fill_rectangle(0, 80 - Font_11x18.height, 160, 80, _color);
+    _renderer->fill_rectangle(0, 0, 160, Font_11x18.height, _color);
+    _renderer->fill_rectangle(0, 80 - Font_11x18.height, 160, 80, _color);
 
-    _display->write_str(25, Font_11x18.height, "Setup Mode", Font_11x18, _color,
-                        ST7735_BLACK);
+    _renderer->write_str(25, Font_11x18.height, "Setup Mode", Font_11x18,
+                         _color, ST7735_BLACK);
+    _renderer->end_frame(true);
     utils::delay_ms(1000);
-    _display->fill_rectangle(0, 0, 160, 80, ST7735_BLACK);
-    _display->write_str(0, 0, "Compass Cal", Font_11x18, ST7735_WHITE,
-                        ST7735_BLACK);
-    _display->write_str(0, 2 * Font_11x18.height,
-                        "Keep moving slowly the device in a figure 8 for ~30s",
-                        Font_7x10, ST7735_WHITE, ST7735_BLACK);
+    _renderer->fill_rectangle(0, 0, 160, 80, ST7735_BLACK);
+    _renderer->write_str(0, 0, "Compass Cal", Font_11x18, ST7735_WHITE,
+                         ST7735_BLACK);
+    _renderer->write_str(0, 2 * Font_11x18.height,
+                         "Keep moving slowly the device in a figure 8 for ~30s",
+                         Font_7x10, ST7735_WHITE, ST7735_BLACK);
+    _renderer->end_frame(true);
 
     err = _magnetometer->calibrate(1000, 25);
-    _display->fill_rectangle(0, Font_11x18.height, 160, 80 - Font_11x18.height,
-                             ST7735_BLACK);
+    _renderer->fill_rectangle(0, Font_11x18.height, 160, 80 - Font_11x18.height,
+                              ST7735_BLACK);
     if (err != ESP_OK)
     {
         ESP_LOGE(TAG, "Magnetometer calibration failed: %s",
                  esp_err_to_name(err));
-        _display->write_str(0, Font_11x18.height, "Calibration Failed",
-                            Font_11x18, ST7735_RED, ST7735_BLACK);
+        _renderer->write_str(0, Font_11x18.height, "Calibration Failed",
+                             Font_11x18, ST7735_RED, ST7735_BLACK);
+        _renderer->end_frame(true);
         utils::delay_ms(2000);
-        _display->fill_screen(ST7735_BLACK);
-        _display->write_str(0, 2 * Font_11x18.height, "Rebooting...",
-                            Font_11x18, ST7735_RED, ST7735_BLACK);
+        _renderer->fill_screen(ST7735_BLACK);
+        _renderer->write_str(0, 2 * Font_11x18.height, "Rebooting...",
+                             Font_11x18, ST7735_RED, ST7735_BLACK);
+        _renderer->end_frame(true);
     }
     else
     {
         ESP_LOGI(TAG, "Magnetometer calibration successful");
         _magnetometer->saveCalibration();
-        _display->write_str(0, Font_11x18.height * 2, "Calibration Done",
-                            Font_11x18, ST7735_GREEN, ST7735_BLACK);
+        _renderer->write_str(0, Font_11x18.height * 2, "Calibration Done",
+                             Font_11x18, ST7735_GREEN, ST7735_BLACK);
+        _renderer->end_frame(true);
         utils::delay_ms(2500);
-        _display->fill_screen(ST7735_BLACK);
-        _display->write_str(0, 2 * Font_11x18.height, "Rebooting...",
-                            Font_11x18, ST7735_GREEN, ST7735_BLACK);
+        _renderer->fill_screen(ST7735_BLACK);
+        _renderer->write_str(0, 2 * Font_11x18.height, "Rebooting...",
+                             Font_11x18, ST7735_GREEN, ST7735_BLACK);
+        _renderer->end_frame(true);
     }
     utils::delay_ms(3000);
-    _display->hold_pins();
 
     esp_restart();
 }
@@ -469,7 +485,9 @@ application_message_t Astrolavos::constructMessage()
 {
     application_message_t msg{};
     msg.magic = ASTROLAVOS_MAGIC_CODE;
-    if (std::isnan(_coordinates.latitude) || std::isnan(_coordinates.longitude))
+    const gnss_location_t coordinates = getCoordinates();
+    if (coordinates.latitude == ASTROLAVOS_COORDINATE_UNKNOWN ||
+        coordinates.longitude == ASTROLAVOS_COORDINATE_UNKNOWN)
     {
         ESP_LOGE(TAG, "Coordinates not set, cannot construct message");
         msg.id = ID_ASTROLAVOS_NOT_INITIALIZED;
@@ -477,15 +495,15 @@ application_message_t Astrolavos::constructMessage()
     }
 
     msg.id = _id;
-    msg.payload = {
-        .coordinates = _coordinates,
-        .wants_to_meet = _i_want_to_meet,
-    };
+    msg.flags = _i_want_to_meet ? ASTROLAVOS_MESSAGE_WANTS_TO_MEET : 0;
+    msg.latitude = coordinates.latitude;
+    msg.longitude = coordinates.longitude;
 
-    ESP_LOGI(TAG, "Constructed message %d: Payload: Lat: %f, Lon: %f, WTM: %s",
-             msg.id, msg.payload.coordinates.latitude,
-             msg.payload.coordinates.longitude,
-             msg.payload.wants_to_meet ? "True" : "False");
+    ESP_LOGI(TAG,
+             "Constructed message %d: Payload: Lat: %ld, Lon: %ld, WTM: %s",
+             msg.id, static_cast<long>(msg.latitude),
+             static_cast<long>(msg.longitude),
+             _i_want_to_meet ? "True" : "False");
 
     return msg;
 }
@@ -504,12 +522,26 @@ void Astrolavos::handleReceivedMessage(application_message_t msg)
         return;
     }
 
+    /* The geodesy relies on the range of the coordinates, as the GNSS gives
+     * them */
+    if (msg.latitude < -ASTROLAVOS_LATITUDE_MAX ||
+        msg.latitude > ASTROLAVOS_LATITUDE_MAX ||
+        msg.longitude < -ASTROLAVOS_LONGITUDE_MAX ||
+        msg.longitude > ASTROLAVOS_LONGITUDE_MAX)
+    {
+        ESP_LOGE(TAG, "Received coordinates out of range: Lat: %ld, Lon: %ld",
+                 static_cast<long>(msg.latitude),
+                 static_cast<long>(msg.longitude));
+        return;
+    }
+
+    const bool wants_to_meet = msg.flags & ASTROLAVOS_MESSAGE_WANTS_TO_MEET;
     ESP_LOGI(TAG,
-             "Handling received message from ID: %d, Payload: Lat: %f, Lon: "
-             "%f, WTM: %s",
-             msg.id, msg.payload.coordinates.latitude,
-             msg.payload.coordinates.longitude,
-             msg.payload.wants_to_meet ? "True" : "False");
+             "Handling received message from ID: %d, Payload: Lat: %ld, Lon: "
+             "%ld, WTM: %s",
+             msg.id, static_cast<long>(msg.latitude),
+             static_cast<long>(msg.longitude),
+             wants_to_meet ? "True" : "False");
     AstrolavosPairedDevice* device = getDevice(msg.id);
     if (!device)
     {
@@ -517,8 +549,13 @@ void Astrolavos::handleReceivedMessage(application_message_t msg)
         return;
     }
 
-    device_data_t data = msg.payload;
+    device_data_t data = {};
+    data.coordinates = {msg.latitude, msg.longitude, 0};
+    data.wants_to_meet = wants_to_meet;
+    const uint32_t generation = device->getGeneration();
     device->updateDevice(data);
+    if (device->getGeneration() != generation)
+        notifyChange();
 }
 
 void Astrolavos::refreshHealthBar()
@@ -529,10 +566,7 @@ void Astrolavos::refreshHealthBar()
      * Batt:xx% GNSS:xx Mag:x
      */
     char buf[23];
-    const int Y = 80 - Font_7x10.height;
-    _display->unhold_pins();
-    _display->fill_rectangle(0, Y, 160, 80, ST7735_BLACK);
-    _display->hold_pins();
+    const uint8_t row = ST7735_TEXT_ROWS - 1;
     char gnss_fixed[3];
     xSemaphoreTake(_health_mutex, portMAX_DELAY);
     if (_healthStatus.gnss.num_satellites == GNSS_NO_SATELLITES)
@@ -565,9 +599,8 @@ void Astrolavos::refreshHealthBar()
     snprintf(buf, sizeof(buf), "Bat:%d%% Sat:%s Hdg:%s",
              _healthStatus.battery.percentage % 100, gnss_fixed, mag_status);
     xSemaphoreGive(_health_mutex);
-    _display->unhold_pins();
-    _display->write_str(0, Y, buf, Font_7x10, ST7735_WHITE, ST7735_BLACK);
-    _display->hold_pins();
+    uint8_t col = _renderer->print(0, row, buf, ST7735_WHITE, ST7735_BLACK);
+    _renderer->clear_cells(col, row);
 
     ESP_LOGI(TAG, "Health Bar: %s", buf);
 }
@@ -592,21 +625,27 @@ void Astrolavos::refreshDevice(int id)
         calculateHeading(id, target_absolute_heading) != ESP_OK)
         is_valid = false;
 
-    const int Y = Font_7x10.height * id; /* Assume id [0,4] */
+    const int row = peerRow(device - _devices.data());
+    if (row < 0)
+        return; /* Scrolled out of the peer list */
     char buf_name[7];
     char buf_data[17];
-    char direction_buf[3];
+    char buf_heading[8] = "";
+    uint8_t arrow;
+    bool has_arrow = false;
     uint16_t bg_color = ST7735_BLACK;
     snprintf(buf_name, sizeof(buf_name), "%s", device->getName());
     if (is_valid)
     {
-        printDirection(calculateDirectionQuart(target_absolute_heading),
-                       direction_buf);
         int target_absolute_heading_int =
             static_cast<int>(target_absolute_heading);
         int distance_int = static_cast<int>(distance);
-        snprintf(buf_data, sizeof(buf_data), " %dm go %s (%d)", distance_int,
-                 direction_buf, target_absolute_heading_int);
+        /* The arrow sits between the distance and the absolute heading */
+        has_arrow = calculateArrow(target_absolute_heading, arrow) == ESP_OK;
+        snprintf(buf_data, sizeof(buf_data), " %dm %s", distance_int,
+                 has_arrow ? "" : "??");
+        snprintf(buf_heading, sizeof(buf_heading), " (%d)",
+                 target_absolute_heading_int);
         i_want_to_meet = device->getWantsToMeet();
         if (i_want_to_meet && !device->isStale())
             bg_color = ST7735_WHITE;
@@ -628,36 +667,422 @@ void Astrolavos::refreshDevice(int id)
     {
         snprintf(buf_data, sizeof(buf_data), ": No Data");
     }
-    _display->unhold_pins();
-    _display->fill_rectangle(0, Y, 160, Font_7x10.height, ST7735_BLACK);
-    _display->write_str(0, Y, buf_name, Font_7x10, device->getColour(),
-                        bg_color);
-    _display->write_str(Font_7x10.width * strlen(device->getName()), Y,
-                        buf_data, Font_7x10, device->getColour(), ST7735_BLACK);
-
-    _display->hold_pins();
-    ESP_LOGI(TAG, "Device %d: %s%s", id, buf_name, buf_data);
+    uint8_t col =
+        _renderer->print(0, row, buf_name, device->getColour(), bg_color);
+    col = _renderer->print(col, row, buf_data, device->getColour(),
+                           ST7735_BLACK);
+    if (has_arrow)
+        col = _renderer->arrow(col, row, arrow, device->getColour(),
+                               ST7735_BLACK);
+    col = _renderer->print(col, row, buf_heading, device->getColour(),
+                           ST7735_BLACK);
+    _renderer->clear_cells(col, row);
+    ESP_LOGI(TAG, "Device %d: %s%s%s", id, buf_name, buf_data, buf_heading);
 
     /*TODO: We could perhaps do something with the freshness */
 }
 
+bool Astrolavos::widgetChanged(widget_t widget, uint32_t generation,
+                               uint32_t stale)
+{
+    widget_state_t& w = _widgets[widget];
+    if (w.drawn && w.generation == generation && w.stale == stale)
+        return false;
+    w = {generation, stale, true};
+    return true;
+}
+
+bool Astrolavos::refreshChangedWidgets(display_profile_t profile)
+{
+    /* The counters only ever grow, so the sum of the counters a widget
+     * depends on changes whenever one of them does */
+    uint32_t devices = 0;
+    uint32_t stale = 0;
+    for (int i = 0; i < ASTROLAVOS_NUMBER_OF_DEVICES; i++)
+    {
+        AstrolavosPairedDevice* device = getDevice(i);
+        if (!device)
+            continue;
+        devices += device->getGeneration();
+        /* Past 32 peers the flags share bits, which only makes a change of
+         * both flags of a pair go unnoticed */
+        stale ^= static_cast<uint32_t>(device->isStale()) << (i % 32);
+    }
+    const uint32_t position = _coordinates_generation + _heading_generation;
+    measurePeers();
+
+    bool changed = false;
+    if (profile == ASTROLAVOS_DISPLAY_GLANCE)
+    {
+        if (widgetChanged(ASTROLAVOS_WIDGET_GLANCE,
+                          _health_generation + _iwtm_generation + position +
+                              devices,
+                          stale))
+        {
+            refreshGlance();
+            changed = true;
+        }
+    }
+    else
+    {
+        if (widgetChanged(ASTROLAVOS_WIDGET_HEALTH,
+                          _health_generation + _heading_generation, 0))
+        {
+            refreshHealthBar();
+            changed = true;
+        }
+        if (widgetChanged(ASTROLAVOS_WIDGET_IWTM, _iwtm_generation, 0))
+        {
+            refreshIwantToMeet();
+            changed = true;
+        }
+#if defined(ASTROLAVOS_RADAR_VIEW)
+        if (widgetChanged(ASTROLAVOS_WIDGET_RADAR, devices + position, stale))
+        {
+            refreshRadar();
+            changed = true;
+        }
+#else
+        scrollPeers();
+        for (int i = 0; i < _n_peers; i++)
+        {
+            AstrolavosPairedDevice& device = _devices[i];
+            if (peerRow(i) < 0)
+                continue;
+            const widget_t widget = static_cast<widget_t>(
+                ASTROLAVOS_WIDGET_DEVICE + device.getId());
+            if (widgetChanged(widget, device.getGeneration() + position,
+                              device.isStale()))
+            {
+                refreshDevice(device.getId());
+                changed = true;
+            }
+        }
+#endif
+    }
+    if (changed)
+        renderScreen();
+    return changed;
+}
+
+#if defined(ASTROLAVOS_RADAR_VIEW)
+void Astrolavos::refreshRadar()
+{
+    for (int i = 0; i < _n_peers; i++)
+    {
+        AstrolavosPairedDevice& device = _devices[i];
+        const int id = device.getId();
+        float distance;
+        float target_absolute_heading;
+        if (calculateDistance(id, distance) != ESP_OK ||
+            calculateHeading(id, target_absolute_heading) != ESP_OK)
+        {
+            _radar.hidePeer(id);
+            continue;
+        }
+        /* The frame is the background the peer list gives the name */
+        uint16_t frame = ST7735_BLACK;
+        if (device.getWantsToMeet())
+            frame = device.isStale() ? ST7735_YELLOW : ST7735_WHITE;
+        else if (device.isStale())
+            frame = ST7735_RED;
+        _radar.setPeer(id, distance, target_absolute_heading,
+                       device.getColour(), frame);
+    }
+    _radar.draw(_renderer, _heading.heading);
+
+    char buf[8];
+    const uint16_t range = _radar.getRange();
+    if (range < 1000)
+        snprintf(buf, sizeof(buf), "%um", range);
+    else
+        snprintf(buf, sizeof(buf), "%ukm", range / 1000);
+    const uint8_t col = _renderer->print(0, 0, buf, ST7735_WHITE, ST7735_BLACK);
+    _renderer->fill_cells(col, 0, ASTROLAVOS_RADAR_LABEL_COLUMNS - col,
+                          ST7735_BLACK);
+}
+#endif
+
+int Astrolavos::peerRow(int index) const
+{
+    if (index < 0 || index >= _n_peers)
+        return -1;
+    /* Position p of the list shows peer p % _n_peers on row
+     * p % ASTROLAVOS_PEER_ROWS and the rows show the positions from
+     * _peer_scroll on. A scroll step moves that window by one, the peer
+     * coming in takes the row of the peer going out and every other row
+     * stays as it is */
+    const int offset = (index - _peer_scroll % _n_peers + _n_peers) % _n_peers;
+    if (offset >= ASTROLAVOS_PEER_ROWS)
+        return -1;
+    return (_peer_scroll + offset) % ASTROLAVOS_PEER_ROWS;
+}
+
+void Astrolavos::measurePeers()
+{
+    /* One snapshot, a fix landing during the batch is measured next time */
+    geodesy_origin_t origin;
+    const uint32_t origin_generation = getOrigin(origin);
+    if (_measured_generation == origin_generation ||
+        origin.latitude == ASTROLAVOS_COORDINATE_UNKNOWN ||
+        origin.longitude == ASTROLAVOS_COORDINATE_UNKNOWN)
+        return;
+    AstrolavosPairedDevice* measured[ASTROLAVOS_NUMBER_OF_DEVICES];
+    uint32_t generation[ASTROLAVOS_NUMBER_OF_DEVICES];
+    int32_t latitude[ASTROLAVOS_NUMBER_OF_DEVICES];
+    int32_t longitude[ASTROLAVOS_NUMBER_OF_DEVICES];
+    uint32_t distance[ASTROLAVOS_NUMBER_OF_DEVICES];
+    uint16_t bearing[ASTROLAVOS_NUMBER_OF_DEVICES];
+    size_t n = 0;
+    for (int i = 0; i < _n_peers; i++)
+    {
+        AstrolavosPairedDevice& device = _devices[i];
+        /* The generation before the position, as in getVector() */
+        generation[n] = device.getPositionGeneration();
+        const gnss_location_t target = device.getCoordinates();
+        if (target.latitude == ASTROLAVOS_COORDINATE_UNKNOWN ||
+            target.longitude == ASTROLAVOS_COORDINATE_UNKNOWN)
+            continue;
+        measured[n] = &device;
+        latitude[n] = target.latitude;
+        longitude[n] = target.longitude;
+        n++;
+    }
+    /* The arrows follow the float heading, the sectors are not needed */
+    const geodesy_batch_t batch = {latitude, longitude, distance,
+                                   bearing,  nullptr,   n};
+    geodesyBatch(origin, 0, 0, batch);
+    for (size_t i = 0; i < n; i++)
+        measured[i]->setVector({distance[i], bearing[i]}, origin_generation,
+                               generation[i]);
+    _measured_generation = origin_generation;
+}
+
+void Astrolavos::scrollPeers()
+{
+    if (_n_peers <= ASTROLAVOS_PEER_ROWS)
+        return;
+    const int64_t now = esp_timer_get_time();
+    if (now - _peer_scroll_ts < ASTROLAVOS_PEER_SCROLL_PERIOD * 1000LL)
+        return;
+    _peer_scroll_ts = now;
+    /* Positions modulo both the peers and the rows keep the same rows */
+    _peer_scroll = (_peer_scroll + 1) % (_n_peers * ASTROLAVOS_PEER_ROWS);
+    const int coming_in = (_peer_scroll + ASTROLAVOS_PEER_ROWS - 1) % _n_peers;
+    _widgets[ASTROLAVOS_WIDGET_DEVICE + _devices[coming_in].getId()].drawn =
+        false;
+}
+
+void Astrolavos::renderScreen()
+{
+    /* The render task pushes everything that changed in this frame at once */
+    _renderer->end_frame();
+}
+
+display_profile_t Astrolavos::updateDisplayProfile()
+{
+    xSemaphoreTake(_health_mutex, portMAX_DELAY);
+    const uint8_t battery = _healthStatus.battery.percentage;
+    xSemaphoreGive(_health_mutex);
+    if (battery != BATTERY_STATUS_UNKNOWN)
+    {
+        if (battery <= ASTROLAVOS_GLANCE_BATTERY_LOW)
+            _battery_low = true;
+        else if (battery >= ASTROLAVOS_GLANCE_BATTERY_LOW +
+                                ASTROLAVOS_GLANCE_BATTERY_HYSTERESIS)
+            _battery_low = false;
+    }
+
+    display_profile_t profile = ASTROLAVOS_DISPLAY_FULL;
+    if (_isolation_mode)
+#if defined(ASTROLAVOS_ISOLATION_GLANCE)
+        profile = ASTROLAVOS_DISPLAY_GLANCE;
+#else
+        profile = ASTROLAVOS_DISPLAY_OFF;
+#endif
+    else if (_battery_low)
+        profile = ASTROLAVOS_DISPLAY_GLANCE;
+    setDisplayProfile(profile);
+    return _display_profile;
+}
+
+void Astrolavos::setDisplayProfile(display_profile_t profile)
+{
+    if (profile == _display_profile)
+        return;
+    ESP_LOGI(TAG, "Display profile %d -> %d", _display_profile, profile);
+
+    const display_profile_t previous = _display_profile;
+    _display_profile = profile;
+    _backlight_level = 0; /* Set by the next updateBacklight() */
+    if (profile == ASTROLAVOS_DISPLAY_OFF)
+    {
+        /* The widgets keep what they drew, so that waking up only needs what
+         * changed while we were off. The panel keeps its memory, or has it
+         * repainted from the framebuffer if its supply was cut */
+        _display_off_ts = esp_timer_get_time();
+        _renderer->turn_off(_display_off_s);
+        /* Nothing else closes a frame while the display is off */
+        _renderer->end_frame();
+        return;
+    }
+    if (previous == ASTROLAVOS_DISPLAY_OFF)
+    {
+        const int64_t off_s =
+            (esp_timer_get_time() - _display_off_ts) / 1000000;
+        _display_off_s = std::min<int64_t>(off_s, UINT16_MAX);
+        _renderer->turn_on();
+    }
+    if (profile == _layout_profile)
+        return;
+
+    if (_layout_profile == ASTROLAVOS_DISPLAY_GLANCE)
+    {
+        _renderer->set_partial_mode(false);
+        _renderer->set_idle_mode(false);
+    }
+    if (profile == ASTROLAVOS_DISPLAY_GLANCE)
+    {
+        _renderer->set_partial_area(
+            0, ASTROLAVOS_GLANCE_COLUMNS * ST7735_TEXT_CELL_WIDTH - 1);
+        _renderer->set_partial_mode(true);
+        _renderer->set_idle_mode(true);
+    }
+
+    /* The profiles lay the screen out differently, start from a blank one */
+    for (uint8_t row = 0; row < ST7735_TEXT_ROWS; row++)
+        _renderer->clear_cells(0, row);
+    for (widget_state_t& widget : _widgets)
+        widget.drawn = false;
+    _layout_profile = profile;
+}
+
+bool Astrolavos::updateBacklight(display_profile_t profile)
+{
+    const int64_t now = esp_timer_get_time();
+    /* A new heading or peer data is something to look at */
+    uint32_t activity = _heading_generation;
+    for (int i = 0; i < ASTROLAVOS_NUMBER_OF_DEVICES; i++)
+    {
+        AstrolavosPairedDevice* device = getDevice(i);
+        if (device)
+            activity += device->getGeneration();
+    }
+
+    xSemaphoreTake(_health_mutex, portMAX_DELAY);
+    if (activity != _activity_generation)
+    {
+        _activity_generation = activity;
+        _backlight.activity(now);
+    }
+    _backlight.account(profile, now);
+    const uint8_t level = _backlight.level(profile, now);
+    if (now - _backlight_report_ts >= ASTROLAVOS_BACKLIGHT_REPORT_PERIOD)
+    {
+        _backlight.logEnergy();
+        _backlight_report_ts = now;
+    }
+    xSemaphoreGive(_health_mutex);
+
+    /* The frame setDisplayProfile() closes with turn_off() puts the
+     * backlight at 0, as account() has it while off */
+    if (profile == ASTROLAVOS_DISPLAY_OFF || level == _backlight_level)
+        return false;
+    _renderer->set_backlight(level, level > _backlight_level
+                                        ? ASTROLAVOS_BACKLIGHT_BRIGHTEN_MS
+                                        : ASTROLAVOS_BACKLIGHT_DIM_MS);
+    _backlight_level = level;
+    return true;
+}
+
+void Astrolavos::refreshGlance()
+{
+    /* Only the first ASTROLAVOS_GLANCE_COLUMNS cells are visible and only the
+     * 8 primary colours survive the idle mode */
+    char buf[ASTROLAVOS_GLANCE_COLUMNS + 1];
+    int nearest = -1;
+    float nearest_distance = 0;
+    int wants_to_meet = 0;
+    for (int i = 0; i < ASTROLAVOS_NUMBER_OF_DEVICES; i++)
+    {
+        AstrolavosPairedDevice* device = getDevice(i);
+        float distance;
+        if (!device || calculateDistance(i, distance) != ESP_OK)
+            continue;
+        if (device->getWantsToMeet() && !device->isStale())
+            wants_to_meet++;
+        if (nearest < 0 || distance < nearest_distance)
+        {
+            nearest = i;
+            nearest_distance = distance;
+        }
+    }
+
+    uint8_t col;
+    float heading;
+    if (nearest >= 0)
+    {
+        AstrolavosPairedDevice* device = getDevice(nearest);
+        col = _renderer->print(0, 0, device->getName(), device->getColour(),
+                               ST7735_BLACK);
+        _renderer->clear_cells(col, 0);
+        snprintf(buf, sizeof(buf), "%dm", static_cast<int>(nearest_distance));
+        col = _renderer->print(0, 1, buf, ST7735_WHITE, ST7735_BLACK);
+        _renderer->clear_cells(col, 1);
+        col = 0;
+        uint8_t arrow;
+        if (calculateHeading(nearest, heading) == ESP_OK &&
+            calculateArrow(heading, arrow) == ESP_OK)
+        {
+            col = _renderer->print(0, 2, "go ", ST7735_WHITE, ST7735_BLACK);
+            col = _renderer->arrow(col, 2, arrow, ST7735_WHITE, ST7735_BLACK);
+        }
+        _renderer->clear_cells(col, 2);
+    }
+    else
+    {
+        col = _renderer->print(0, 0, "No Data", ST7735_WHITE, ST7735_BLACK);
+        _renderer->clear_cells(col, 0);
+        _renderer->clear_cells(0, 1);
+        _renderer->clear_cells(0, 2);
+    }
+
+    col = 0;
+    if (wants_to_meet)
+    {
+        snprintf(buf, sizeof(buf), "WTM:%d", wants_to_meet % 10);
+        col = _renderer->print(0, 4, buf, ST7735_BLACK, ST7735_YELLOW);
+    }
+    _renderer->clear_cells(col, 4);
+
+    col = 0;
+    if (_i_want_to_meet)
+        col = _renderer->print(0, 6, "IWTM", ST7735_BLACK, ST7735_WHITE);
+    _renderer->clear_cells(col, 6);
+
+    xSemaphoreTake(_health_mutex, portMAX_DELAY);
+    const uint8_t battery = _healthStatus.battery.percentage;
+    xSemaphoreGive(_health_mutex);
+    if (battery == BATTERY_STATUS_UNKNOWN)
+        snprintf(buf, sizeof(buf), "B:xx");
+    else
+        snprintf(buf, sizeof(buf), "B:%d%%", battery % 100);
+    col = _renderer->print(0, 7, buf, _battery_low ? ST7735_RED : ST7735_WHITE,
+                           ST7735_BLACK);
+    _renderer->clear_cells(col, 7);
+}
+
 void Astrolavos::refreshIwantToMeet()
 {
     /*Print our WantToMeet Mode*/
-    const uint16_t Y_WTM = 80 - (2 * Font_7x10.height);
-    _display->unhold_pins();
-    _display->fill_rectangle(0, Y_WTM, 160, Font_7x10.height, ST7735_BLACK);
+    const uint8_t row = ST7735_TEXT_ROWS - 2;
+    _renderer->clear_cells(0, row);
     if (_i_want_to_meet)
     {
-        _display->fill_rectangle(0, Y_WTM, 3 * Font_7x10.width,
-                                 Font_7x10.height, _color);
-        char wtm_buf[] = "I Want To Meet";
-        _display->write_str(4 * Font_7x10.width, Y_WTM, wtm_buf, Font_7x10,
-                            _color, ST7735_BLACK);
-        _display->fill_rectangle(20 * Font_7x10.width, Y_WTM, 160,
-                                 Font_7x10.height, _color);
+        _renderer->fill_cells(0, row, 3, _color);
+        _renderer->print(4, row, "I Want To Meet", _color, ST7735_BLACK);
+        _renderer->clear_cells(20, row, _color);
     }
-    _display->hold_pins();
     ESP_LOGI(TAG, "I Want To Meet: %s", _i_want_to_meet ? "True" : "False");
 }
 
@@ -722,41 +1147,56 @@ void Astrolavos::initIWTMInterrupt()
     gpio_isr_handler_add(heltec::PIN_IWTM_SWITCH, iwtm_isr_handler, this);
 }
 
-void Astrolavos::init(HT_st7735* display, LoRa* lora)
+void Astrolavos::init(HT_st7735_renderer* renderer, LoRa* lora)
 {
     _sleep_duration = &normal_sleep_duration;
-    _display = display;
+    _task = xTaskGetCurrentTaskHandle();
+    _renderer = renderer;
     _lora = lora;
     _id = this_device.id;
     strncpy(_name, this_device.name, sizeof(_name));
     _color = this_device.colour;
     _health_mutex = xSemaphoreCreateMutex();
+    _position_mutex = xSemaphoreCreateMutex();
     _healthStatus.battery = {BATTERY_STATUS_UNKNOWN, 0};
     _healthStatus.gnss = {GNSS_NO_SATELLITES, 0};
     _healthStatus.magnetometer = {MAGNETOMETER_UNINITIALIZED, 0};
-    _coordinates = {std::nanf("No Latitude"), std::nanf("No Longitude"), 0};
+    _coordinates = {ASTROLAVOS_COORDINATE_UNKNOWN,
+                    ASTROLAVOS_COORDINATE_UNKNOWN, 0};
+    _origin.latitude = ASTROLAVOS_COORDINATE_UNKNOWN;
+    _origin.longitude = ASTROLAVOS_COORDINATE_UNKNOWN;
     ESP_LOGI(TAG, "Initializing Astrolavos");
-    _display->unhold_pins();
-    _display->fill_screen(ST7735_BLACK);
-    _display->fill_rectangle(0, 0, 160, Font_11x18.height, _color);
-    _display->fill_rectangle(0, 80 - Font_11x18.height, 160, 80, _color);
-    _display->write_str(25, Font_11x18.height, "Astrolavos", Font_11x18, _color,
-                        ST7735_BLACK);
+    /* The emblem takes our colour, the frame is waited for so the palette
+     * can live on the stack */
+    uint16_t palette[ST7735_IMAGE_MAX_COLORS];
+    std::copy_n(astrolavos_splash.palette, astrolavos_splash.palette_size,
+                palette);
+    palette[ASTROLAVOS_SPLASH_DEVICE_COLOUR] = _color;
+    st7735_image_t splash = astrolavos_splash;
+    splash.palette = palette;
+    _renderer->fill_screen(ST7735_BLACK);
+    _renderer->fill_rectangle(0, 0, 160, Font_11x18.height, _color);
+    _renderer->fill_rectangle(0, 80 - Font_11x18.height, 160, 80, _color);
+    _renderer->draw_image(ASTROLAVOS_SPLASH_X, (80 - splash.height) / 2,
+                          splash);
+    _renderer->write_str(ASTROLAVOS_SPLASH_TEXT_X, Font_11x18.height,
+                         "Astrolavos", Font_11x18, _color, ST7735_BLACK);
     char buf[4 + 6 + 1]; /* 4 for "Hey ", 6 for name, 1 for null terminator */
     snprintf(buf, sizeof(buf), "Hey %s", _name);
-    _display->write_str(3 * Font_11x18.width, Font_11x18.height * 2, buf,
-                        Font_11x18, _color, ST7735_BLACK);
-    _display->hold_pins();
+    _renderer->write_str(ASTROLAVOS_SPLASH_TEXT_X, Font_11x18.height * 2, buf,
+                         Font_11x18, _color, ST7735_BLACK);
+    _renderer->end_frame(true);
     initialisePairedDevices();
     initSwitchInterrupt();
     utils::delay_ms(ASTROLAVOS_WELCOME_SLEEP);
-    _display->unhold_pins();
-    _display->fill_screen(ST7735_BLACK);
-    _display->hold_pins();
+    _renderer->fill_screen(ST7735_BLACK);
+    _renderer->end_frame(true);
+    _renderer->reset_cells();
     initIWTMInterrupt();
 
     esp_sleep_enable_gpio_wakeup();
 
+    _backlight.activity(esp_timer_get_time());
     _is_booted = true;
     ESP_LOGI(TAG, "Astrolavos initialized with ID: %d, Name: %s", _id, _name);
 }
@@ -770,10 +1210,9 @@ void astrolavos_task(void* args)
     astrolavos::astrolavos_args_t* task_args =
         reinterpret_cast<astrolavos::astrolavos_args_t*>(args);
     astrolavos::Astrolavos* astrolavos_app = task_args->app;
-    HT_st7735* display = reinterpret_cast<HT_st7735*>(task_args->display);
     LoRa* lora = reinterpret_cast<LoRa*>(task_args->lora);
     ESP_LOGI(TAG, "Astrolavos Task started");
-    astrolavos_app->init(display, lora);
+    astrolavos_app->init(task_args->renderer, lora);
     if (astrolavos_app->isSetupRequested())
     {
         ESP_LOGI(TAG, "Setup requested, entering setup mode");
@@ -792,18 +1231,21 @@ void astrolavos_task(void* args)
             ESP_LOGI(TAG, "I Want To Meet mode triggered");
             astrolavos_app->updateIWantToMeet();
         }
-        if (!astrolavos_app->getIsolationMode())
+        astrolavos::display_profile_t profile =
+            astrolavos_app->updateDisplayProfile();
+        const bool backlight = astrolavos_app->updateBacklight(profile);
+        if (profile != astrolavos::ASTROLAVOS_DISPLAY_OFF)
         {
+            /* Only the widgets whose inputs changed are drawn, an idle screen
+             * costs nothing unless the backlight has to change */
             esp_pm_lock_acquire(lock);
-
-            astrolavos_app->refreshHealthBar();
-            astrolavos_app->refreshIwantToMeet();
-            for (int i = 0; i < ASTROLAVOS_NUMBER_OF_DEVICES; i++)
-            {
-                astrolavos_app->refreshDevice(i);
-            }
+            if (!astrolavos_app->refreshChangedWidgets(profile) && backlight)
+                astrolavos_app->renderScreen();
+            esp_pm_lock_release(lock);
         }
-        esp_pm_lock_release(lock);
-        utils::delay_ms(astrolavos_app->getSleepDuration()->main_app_refresh);
+        /* Any state change wakes us up, the timeout catches peers going
+         * stale */
+        astrolavos_app->waitForChange(
+            astrolavos_app->getSleepDuration()->main_app_refresh);
     }
 }
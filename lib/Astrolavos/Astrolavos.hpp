@@ -11,9 +11,13 @@
 
 #pragma once
 
+#include "AstrolavosBacklight.hpp"
+#include "AstrolavosGeodesy.hpp"
 #include "AstrolavosPairedDevice.hpp"
+#include "AstrolavosRadar.hpp"
 #include "Astrolavos_types.hpp"
 #include <HT_st7735.hpp>
+#include <HT_st7735_renderer.hpp>
 #include <QMC5883L.hpp>
 #include <array>
 #include <lora.hpp>
@@ -24,7 +28,7 @@ namespace astrolavos
 class Astrolavos
 {
 public:
-    void init(HT_st7735* display, LoRa* lora);
+    void init(HT_st7735_renderer* renderer, LoRa* lora);
 
     /**
      * @brief Update the battery health status.
@@ -74,6 +78,15 @@ public:
      */
     void updateCoordinates(const gnss_location_t& coordinates);
 
+    /**
+     * @brief Update the time of day, it drives the night dimming of the
+     * backlight.
+     *
+     * @param hour UTC hour from GNSS
+     * @param minute
+     */
+    void updateTime(uint8_t hour, uint8_t minute);
+
     /**
      * @brief Refresh the health bar on the display based on the current health
      * status.
@@ -95,6 +108,65 @@ public:
      */
     void refreshDevice(int id);
 
+#if defined(ASTROLAVOS_RADAR_VIEW)
+    /**
+     * @brief Refresh the radar with the latest position of every device and
+     * the range it is drawn at. Only the dots that moved are sent.
+     *
+     */
+    void refreshRadar();
+#endif
+
+    /**
+     * @brief Close the frame, the render task sends the rows that the
+     * refresh calls changed to the display.
+     *
+     */
+    void renderScreen();
+
+    /**
+     * @brief Refresh only the widgets whose inputs changed since they were
+     * last drawn, and close the frame if any did. When nothing changed
+     * nothing is sent to the render task.
+     *
+     * @param profile the display profile in use
+     * @return true if a frame was rendered
+     */
+    bool refreshChangedWidgets(display_profile_t profile);
+
+    /**
+     * @brief Sleep until one of the inputs of the screen changes, or at most
+     * timeout_ms. Peers also go stale with time alone, the timeout bounds how
+     * late that shows.
+     *
+     * @param timeout_ms
+     */
+    void waitForChange(uint32_t timeout_ms);
+
+    /**
+     * @brief Pick the display profile from the isolation mode and the battery
+     * level and switch the panel to it.
+     *
+     * @return display_profile_t the profile in use
+     */
+    display_profile_t updateDisplayProfile();
+
+    /**
+     * @brief Fade the backlight to the level the backlight policy wants. The
+     * change is executed with the next frame.
+     *
+     * @param profile the display profile in use
+     * @return true if a level was sent and a frame has to be closed for it
+     */
+    bool updateBacklight(display_profile_t profile);
+
+    /**
+     * @brief Refresh the glance strip: the nearest peer, the peers that want
+     * to meet, our IWTM status and the battery.
+     *
+     */
+    void refreshGlance();
+
     /**
      * @brief Get the Sleep Duration
      *
@@ -224,30 +296,34 @@ public:
 
 private:
     /**
-     * @brief Calculate the heading to the device with the given ID.
+     * @brief Distance and bearing to the device with the given ID, cached
+     * by the device until one of the two positions changes.
      *
      * @param id
-     * @return float the degrees [0, 360) or -1 if the heading cannot be
-     * calculated.
+     * @param vector
+     * @return esp_err_t ESP_ERR_INVALID_ARG if the position of the device is
+     * unknown, ESP_ERR_INVALID_STATE if ours is
      */
-    esp_err_t calculateHeading(int id, float& heading);
+    esp_err_t calculateVector(int id, geodesy_vector_t& vector);
 
     /**
-     * @brief Calculate the direction quarterion based on the heading angle.
+     * @brief Calculate the heading to the device with the given ID.
      *
-     * @param heading_angle
-     * @return direction_t
+     * @param id
+     * @return float the degrees [0, 360) or -1 if the heading cannot be
+     * calculated.
      */
-    direction_t calculateDirectionQuart(float heading);
+    esp_err_t calculateHeading(int id, float& heading);
 
     /**
-     * @brief  Print the direction + null terminate
+     * @brief Pick the arrow sprite pointing to the target, relative to our
+     * heading.
      *
-     * @param direction
-     * @param buf a buf of size 3 to hold the direction string and null
-     * termination
+     * @param target_heading the absolute heading to the target in degrees
+     * @param arrow the st7735_arrows index
+     * @return esp_err_t ESP_ERR_INVALID_STATE if our heading is unknown
      */
-    void printDirection(direction_t direction, char buf[3]);
+    esp_err_t calculateArrow(float target_heading, uint8_t& arrow);
 
     /**
      * @brief Calculate the distance to the device with the given ID.
@@ -290,17 +366,81 @@ private:
      */
     void initIWTMInterrupt();
 
+    /**
+     * @brief Record the inputs a widget is about to be drawn with.
+     *
+     * @return true if they differ from the ones it was last drawn with
+     */
+    bool widgetChanged(widget_t widget, uint32_t generation, uint32_t stale);
+
+    /**
+     * @brief The row of the peer list showing a peer
+     *
+     * @param index the index of the peer in _devices
+     * @return int the row, or -1 if the peer is scrolled out of the list
+     */
+    int peerRow(int index) const;
+
+    /**
+     * @brief Scroll the peer list by one peer every
+     * ASTROLAVOS_PEER_SCROLL_PERIOD, when there are more peers than rows.
+     */
+    void scrollPeers();
+
+    /**
+     * @brief Take a consistent snapshot of the terms of our position and the
+     * generation they belong to, as the GNSS task writes them together.
+     *
+     * @param origin the terms of our position
+     * @return uint32_t _coordinates_generation of origin
+     */
+    uint32_t getOrigin(geodesy_origin_t& origin);
+
+    /**
+     * @brief When our position changed, measure every peer in one
+     * geodesyBatch() and leave the results in their caches, where
+     * calculateVector() finds them.
+     */
+    void measurePeers();
+
+    /**
+     * @brief Wake the task waiting in waitForChange(). The ISR variant is
+     * used by the trigger methods.
+     */
+    void notifyChange();
+    void notifyChangeFromISR();
+
+    /**
+     * @brief Switch the panel to the given display profile. Turning the
+     * display off keeps the screen, back on only the widgets that changed
+     * meanwhile are drawn.
+     *
+     * @param profile
+     */
+    void setDisplayProfile(display_profile_t profile);
+
     std::array<AstrolavosPairedDevice, ASTROLAVOS_NUMBER_OF_DEVICES>
         _devices;                  /* Array of paired devices */
     health_status_t _healthStatus; /* Health status of the Astrolavos system */
     heading_t _heading;            /* Heading information of Astrolavos */
-    HT_st7735* _display;           /* Reference to the display */
+    HT_st7735_renderer* _renderer; /* Render task owning the display */
+    display_profile_t _display_profile = ASTROLAVOS_DISPLAY_FULL;
+    /* The profile the screen is laid out for, kept while the display is off */
+    display_profile_t _layout_profile = ASTROLAVOS_DISPLAY_FULL;
+    int64_t _display_off_ts = 0; /* When the display was turned off */
+    /* The length of the last off period, in s, which the next is expected
+     * to last as well */
+    uint16_t _display_off_s = ASTROLAVOS_DISPLAY_OFF_EXPECTED;
+    bool _battery_low = false; /* Battery below the glance threshold */
     QMC5883L* _magnetometer = nullptr; /* Pointer to Magnetometer instance */
     gnss_location_t _coordinates;      /* Coordinates of Astrolavos */
+    geodesy_origin_t _origin = {};     /* Terms of _coordinates for geodesy */
     int _id = ID_ASTROLAVOS_NOT_INITIALIZED; /* Our ID processed */
     char _name[6];                           /* Name of the Astrolavos device */
     uint16_t _color = 0x0000;
     SemaphoreHandle_t _health_mutex = nullptr;
+    /* Guards _coordinates, _origin and _coordinates_generation */
+    SemaphoreHandle_t _position_mutex = nullptr;
     bool _isolation_mode_triggered = false; /* Isolation mode flag */
     bool _isolation_mode = false;           /* Isolation mode */
     const sleep_duration_t* _sleep_duration = nullptr;
@@ -309,11 +449,29 @@ private:
     bool _is_booted = false;       /* Indicates whether Astrolavos is booted */
     bool _setup_requested = false; /* Indicates whether setup is requested */
     LoRa* _lora;
+    /* Generation counters, bumped when an input of the screen changes */
+    uint32_t _health_generation = 0;
+    uint32_t _heading_generation = 0;
+    uint32_t _coordinates_generation = 0;
+    uint32_t _iwtm_generation = 0;
+    uint32_t _measured_generation = 0; /* Of our position by measurePeers() */
+    widget_state_t _widgets[ASTROLAVOS_WIDGET_COUNT] = {}; /* As drawn */
+    int _n_peers = 0;            /* Configured entries of _devices */
+    int _peer_scroll = 0;        /* First position of the peer list shown */
+    int64_t _peer_scroll_ts = 0; /* Last scroll step */
+#if defined(ASTROLAVOS_RADAR_VIEW)
+    AstrolavosRadar _radar; /* Dots as drawn, in place of the peer list */
+#endif
+    TaskHandle_t _task = nullptr; /* Task drawing the screen */
+    AstrolavosBacklight _backlight;    /* Dimming policy */
+    uint8_t _backlight_level = 0;      /* Last level sent, 0 to send again */
+    uint32_t _activity_generation = 0; /* Heading and peers, as last seen */
+    int64_t _backlight_report_ts = 0;  /* Last energy estimate logged */
 };
 
 typedef struct
 {
-    HT_st7735* display;
+    HT_st7735_renderer* renderer;
     LoRa* lora;
     astrolavos::Astrolavos* app; /* Reference to the Astrolavos instance */
 } astrolavos_args_t;
@@ -0,0 +1,138 @@
+/**
+ * @file AstrolavosBacklight.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Backlight dimming policies and their energy estimate
+ * @version 0.1
+ * @date 2025-07-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "AstrolavosBacklight.hpp"
+#include "esp_log.h"
+#include <algorithm>
+
+#ifndef ASTROLAVOS_BACKLIGHT_IDLE_TIMEOUT
+#define ASTROLAVOS_BACKLIGHT_IDLE_TIMEOUT 30 /* s without changes to dim */
+#endif
+
+#ifndef ASTROLAVOS_BACKLIGHT_CURRENT_MA
+#define ASTROLAVOS_BACKLIGHT_CURRENT_MA 20 /* Backlight current at 100% */
+#endif
+
+#ifndef ASTROLAVOS_UTC_OFFSET_MINUTES
+#define ASTROLAVOS_UTC_OFFSET_MINUTES 0 /* Local time minus UTC */
+#endif
+
+constexpr const char* TAG = "AstrolavosBacklight";
+
+namespace astrolavos
+{
+constexpr uint8_t ASTROLAVOS_BACKLIGHT_FULL = 80;   /* % */
+constexpr uint8_t ASTROLAVOS_BACKLIGHT_GLANCE = 20; /* % */
+constexpr uint8_t ASTROLAVOS_BACKLIGHT_DIM = 10;    /* % when idle */
+constexpr uint8_t ASTROLAVOS_BACKLIGHT_MIN = 2;     /* % still readable */
+/* Share of the level kept at night, in % */
+constexpr uint8_t ASTROLAVOS_BACKLIGHT_NIGHT_SCALE = 30;
+/* Local time the day starts and ends at, the level ramps over twilight */
+constexpr int16_t ASTROLAVOS_BACKLIGHT_DAWN = 7 * 60;  /* minutes */
+constexpr int16_t ASTROLAVOS_BACKLIGHT_DUSK = 20 * 60; /* minutes */
+constexpr int16_t ASTROLAVOS_BACKLIGHT_TWILIGHT = 60;  /* minutes */
+constexpr int16_t ASTROLAVOS_MINUTES_PER_DAY = 24 * 60;
+constexpr int64_t ASTROLAVOS_US_PER_MINUTE = 60 * 1000 * 1000;
+
+static const char* const policy_names[ASTROLAVOS_BACKLIGHT_POLICY_COUNT] = {
+    "fixed", "idle", "ambient"};
+
+void AstrolavosBacklight::activity(int64_t now_us) { _last_activity = now_us; }
+
+void AstrolavosBacklight::updateTime(uint8_t hour, uint8_t minute,
+                                     int64_t now_us)
+{
+    int minutes = hour * 60 + minute + ASTROLAVOS_UTC_OFFSET_MINUTES;
+    minutes %= ASTROLAVOS_MINUTES_PER_DAY;
+    if (minutes < 0)
+        minutes += ASTROLAVOS_MINUTES_PER_DAY;
+    _minute_of_day = static_cast<int16_t>(minutes);
+    _time_ts = now_us;
+}
+
+uint8_t AstrolavosBacklight::dayScale(int64_t now_us) const
+{
+    if (_minute_of_day < 0)
+        return 100;
+    const int16_t now = (_minute_of_day + (now_us - _time_ts) /
+                                              ASTROLAVOS_US_PER_MINUTE) %
+                        ASTROLAVOS_MINUTES_PER_DAY;
+    /* Minutes into the day, counted from the nearer of dawn and dusk, and
+     * negative at night */
+    const int16_t daylight = std::min(now - ASTROLAVOS_BACKLIGHT_DAWN,
+                                      ASTROLAVOS_BACKLIGHT_DUSK - now);
+    const int16_t ramp = std::clamp<int16_t>(daylight, 0,
+                                             ASTROLAVOS_BACKLIGHT_TWILIGHT);
+    return ASTROLAVOS_BACKLIGHT_NIGHT_SCALE +
+           (100 - ASTROLAVOS_BACKLIGHT_NIGHT_SCALE) * ramp /
+               ASTROLAVOS_BACKLIGHT_TWILIGHT;
+}
+
+uint8_t AstrolavosBacklight::level(backlight_policy_t policy,
+                                   display_profile_t profile,
+                                   int64_t now_us) const
+{
+    uint8_t level;
+    switch (profile)
+    {
+        case ASTROLAVOS_DISPLAY_FULL:
+            level = ASTROLAVOS_BACKLIGHT_FULL;
+            break;
+        case ASTROLAVOS_DISPLAY_GLANCE:
+            level = ASTROLAVOS_BACKLIGHT_GLANCE;
+            break;
+        default:
+            return 0;
+    }
+    if (policy == ASTROLAVOS_BACKLIGHT_FIXED)
+        return level;
+
+    const int64_t idle = now_us - _last_activity;
+    if (idle >= ASTROLAVOS_BACKLIGHT_IDLE_TIMEOUT * 1000000LL)
+        level = std::min(level, ASTROLAVOS_BACKLIGHT_DIM);
+    if (policy == ASTROLAVOS_BACKLIGHT_AMBIENT)
+        level = std::max<uint8_t>(level * dayScale(now_us) / 100,
+                                  ASTROLAVOS_BACKLIGHT_MIN);
+    return level;
+}
+
+void AstrolavosBacklight::account(display_profile_t profile, int64_t now_us)
+{
+    if (_accounted_ts >= 0)
+    {
+        const int64_t dt = now_us - _accounted_ts;
+        for (int i = 0; i < ASTROLAVOS_BACKLIGHT_POLICY_COUNT; i++)
+            _charge[i] += _levels[i] / 100.0f *
+                          ASTROLAVOS_BACKLIGHT_CURRENT_MA * dt / 1e6f;
+        _accounted_us += dt;
+    }
+    for (int i = 0; i < ASTROLAVOS_BACKLIGHT_POLICY_COUNT; i++)
+        _levels[i] = level(static_cast<backlight_policy_t>(i), profile, now_us);
+    _accounted_ts = now_us;
+}
+
+float AstrolavosBacklight::getAverageCurrent(backlight_policy_t policy) const
+{
+    if (!_accounted_us)
+        return 0;
+    return _charge[policy] / (_accounted_us / 1e6f);
+}
+
+void AstrolavosBacklight::logEnergy() const
+{
+    for (int i = 0; i < ASTROLAVOS_BACKLIGHT_POLICY_COUNT; i++)
+        ESP_LOGI(TAG, "%s%s: %.2f mAh over %lld s, %.2f mA average",
+                 policy_names[i], i == _policy ? " (in use)" : "",
+                 _charge[i] / 3600.0f, _accounted_us / 1000000,
+                 getAverageCurrent(static_cast<backlight_policy_t>(i)));
+}
+
+} // namespace astrolavos
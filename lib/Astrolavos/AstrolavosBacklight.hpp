@@ -0,0 +1,94 @@
+/**
+ * @file AstrolavosBacklight.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Backlight dimming policies and their energy estimate
+ * @version 0.1
+ * @date 2025-07-29
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "Astrolavos_types.hpp"
+
+namespace astrolavos
+{
+class AstrolavosBacklight
+{
+public:
+    void setPolicy(backlight_policy_t policy) { _policy = policy; }
+    backlight_policy_t getPolicy() const { return _policy; }
+
+    /**
+     * @brief Something on the screen changed or a button was pressed, the
+     * idle timeout starts over.
+     *
+     * @param now_us esp_timer time
+     */
+    void activity(int64_t now_us);
+
+    /**
+     * @brief Update the time of day, the clock runs on the esp_timer until
+     * the next update.
+     *
+     * @param hour UTC
+     * @param minute
+     * @param now_us esp_timer time the time was valid at
+     */
+    void updateTime(uint8_t hour, uint8_t minute, int64_t now_us);
+
+    /**
+     * @brief The backlight level a policy wants.
+     *
+     * @param policy
+     * @param profile the display profile in use
+     * @param now_us esp_timer time
+     * @return uint8_t the level in %
+     */
+    uint8_t level(backlight_policy_t policy, display_profile_t profile,
+                  int64_t now_us) const;
+    uint8_t level(display_profile_t profile, int64_t now_us) const
+    {
+        return level(_policy, profile, now_us);
+    }
+
+    /**
+     * @brief Add the energy every policy would have spent since the last
+     * call, so that the policies can be compared on the same day of use.
+     * The levels are sampled at each call and the fades are ignored.
+     *
+     * @param profile the display profile in use from now on
+     * @param now_us esp_timer time
+     */
+    void account(display_profile_t profile, int64_t now_us);
+
+    /**
+     * @brief Get the average backlight current of a policy since boot.
+     *
+     * @param policy
+     * @return float mA, from ASTROLAVOS_BACKLIGHT_CURRENT_MA at 100%
+     */
+    float getAverageCurrent(backlight_policy_t policy) const;
+
+    /** @brief Log the estimate of every policy */
+    void logEnergy() const;
+
+private:
+    /**
+     * @brief Scale of the level at the current time of day, 100 during the
+     * day and ASTROLAVOS_BACKLIGHT_NIGHT_SCALE at night.
+     */
+    uint8_t dayScale(int64_t now_us) const;
+
+    backlight_policy_t _policy = ASTROLAVOS_BACKLIGHT_POLICY;
+    int64_t _last_activity = 0;
+    int16_t _minute_of_day = -1; /* Local time, -1 until it is known */
+    int64_t _time_ts = 0;        /* esp_timer time of _minute_of_day */
+    int64_t _accounted_ts = -1;  /* Last account() call */
+    uint8_t _levels[ASTROLAVOS_BACKLIGHT_POLICY_COUNT] = {}; /* Since then */
+    float _charge[ASTROLAVOS_BACKLIGHT_POLICY_COUNT] = {};   /* mA * s */
+    int64_t _accounted_us = 0; /* Time covered by _charge */
+};
+
+} // namespace astrolavos
@@ -0,0 +1,333 @@
+/**
+ * @file AstrolavosGeodesy.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Distance and bearing between two positions, on a plane tangent to
+ * our position for nearby peers and with Haversine for the others
+ * @version 0.1
+ * @date 2025-08-07
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "AstrolavosGeodesy.hpp"
+#include "AstrolavosTrig.hpp"
+#include "Astrolavos_types.hpp"
+#include <TinyGPS++.hpp>
+#include <cmath>
+#include <cstdlib>
+
+namespace astrolavos
+{
+constexpr float GEODESY_DEG_TO_RAD = static_cast<float>(DEG_TO_RAD);
+constexpr float GEODESY_RAD_TO_DEG = static_cast<float>(RAD_TO_DEG);
+constexpr int GEODESY_Q = 30; /* Fraction bits of the cos and sin */
+/* Radians of a coordinate unit */
+constexpr double GEODESY_RAD_PER_UNIT =
+    DEG_TO_RAD / ASTROLAVOS_COORDINATE_SCALE;
+/* The same, times 2^44 */
+constexpr int64_t GEODESY_RAD_PER_UNIT_Q44 =
+    static_cast<int64_t>(GEODESY_RAD_PER_UNIT * (1LL << 44) + 0.5);
+/* The offsets are taken with 8 fraction bits, to cm times 2^32 */
+constexpr int GEODESY_DISTANCE_Q = 8;
+constexpr uint64_t GEODESY_CM_PER_UNIT_Q32 = static_cast<uint64_t>(
+    EARTH_RADIUS_M * 100.0 * GEODESY_RAD_PER_UNIT *
+        (1LL << (32 - GEODESY_DISTANCE_Q)) +
+    0.5);
+/* The range of the plane, in coordinate units of latitude */
+constexpr int64_t GEODESY_LOCAL_RANGE = static_cast<int64_t>(
+    ASTROLAVOS_GEODESY_LOCAL_RANGE / (EARTH_RADIUS_M * GEODESY_RAD_PER_UNIT));
+constexpr int64_t GEODESY_HALF_TURN = 180LL * ASTROLAVOS_COORDINATE_SCALE;
+/* atan(z) on [0, 1], odd polynomial in Q15, within 1e-5 rad */
+constexpr int32_t GEODESY_ATAN_Q15[] = {32764, -10823, 5903, -2790, 683};
+
+static_assert((GEODESY_LOCAL_RANGE << GEODESY_DISTANCE_Q) < (1LL << 31),
+              "The squared offsets of the plane have to fit in 63 bits");
+
+#if ASTROLAVOS_GEODESY_LANES > 1
+/* Peers measured together by geodesyBatch() */
+typedef int64_t geodesy_lanes_t
+    __attribute__((vector_size(ASTROLAVOS_GEODESY_LANES * sizeof(int64_t))));
+#endif
+
+/* The plane is measured with the same templates for one peer, with T an
+ * int64_t, and for the lanes of geodesyBatch(), with T a geodesy_lanes_t.
+ * They have no branches on the values so both give the same results, the
+ * comparisons and ?: act per lane */
+
+template <typename T> static T abs_of(T v) { return v < 0 ? -v : v; }
+
+/* A Q30 value times an offset in coordinate units, as radians: Q30 */
+template <typename Q, typename T> static T times_rad(Q q30, T units)
+{
+    return ((q30 * units) >> 12) * GEODESY_RAD_PER_UNIT_Q44 >> 32;
+}
+
+static int64_t isqrt(int64_t v) { return trigSqrt(v); }
+
+#if ASTROLAVOS_GEODESY_LANES > 1
+/* The lanes have no branches to leave the loop of trigSqrt() early. The
+ * square root of a double is within one of the root, which is put right in
+ * integers */
+static geodesy_lanes_t isqrt(geodesy_lanes_t v)
+{
+    typedef double geodesy_real_t
+        __attribute__((vector_size(ASTROLAVOS_GEODESY_LANES * sizeof(double))));
+    geodesy_real_t real = __builtin_convertvector(v, geodesy_real_t);
+    for (int k = 0; k < ASTROLAVOS_GEODESY_LANES; k++)
+        real[k] = __builtin_sqrt(real[k]);
+    geodesy_lanes_t root = __builtin_convertvector(real, geodesy_lanes_t);
+    root = root * root > v ? root - 1 : root;
+    root = (root + 1) * (root + 1) <= v ? root + 1 : root;
+    return root;
+}
+#endif
+
+/**
+ * @brief The bearing of a vector, in integer arithmetic.
+ *
+ * @param east
+ * @param north
+ * @return T hundredths of a degree [0, 36000)
+ */
+template <typename T> static T bearing_of(T east, T north)
+{
+    const T ae = abs_of(east);
+    const T an = abs_of(north);
+    /* Fold into the first octant, z = tan of the smaller angle */
+    const auto steep = ae > an;
+    const T small = steep ? an : ae;
+    const T big = steep ? ae : an;
+    const T z = (small << 15) / (big == 0 ? big + 1 : big);
+    const T z2 = (z * z) >> 15;
+    T p = z - z + GEODESY_ATAN_Q15[4];
+    for (int i = 3; i >= 0; i--)
+        p = GEODESY_ATAN_Q15[i] + ((p * z2) >> 15);
+    /* Radians in Q15 to hundredths of a degree, rounded: 18000 / pi / 2^15
+     * is 36000 / 205887 */
+    const T rad = (p * z) >> 15;
+    T angle = (rad * 36000 + 102943) / 205887;
+    angle = steep ? 9000 - angle : angle;
+    angle = north < 0 ? 18000 - angle : angle;
+    angle = east < 0 ? 36000 - angle : angle;
+    return angle % 36000;
+}
+
+/**
+ * @brief The offset of a point from the origin, in coordinate units. It is
+ * zero where the point is out of the reach of the plane.
+ *
+ * @return true, per lane, if the point is close enough to the origin for
+ * the plane
+ */
+template <typename T>
+static auto offset(const geodesy_origin_t& origin, T latitude, T longitude,
+                   T& dlat, T& dlon)
+{
+    dlat = latitude - origin.latitude;
+    dlon = longitude - origin.longitude;
+    dlon = dlon > GEODESY_HALF_TURN ? dlon - 2 * GEODESY_HALF_TURN : dlon;
+    dlon = dlon < -GEODESY_HALF_TURN ? dlon + 2 * GEODESY_HALF_TURN : dlon;
+    const T east = (dlon * origin.cos_lat) >> GEODESY_Q;
+    /* Neither square overflows, the offsets are within half a turn */
+    const auto local = (abs_of(dlat) <= GEODESY_LOCAL_RANGE) &
+                       (abs_of(east) <= GEODESY_LOCAL_RANGE) &
+                       (dlat * dlat + east * east <=
+                        GEODESY_LOCAL_RANGE * GEODESY_LOCAL_RANGE);
+    dlat = local ? dlat : 0;
+    dlon = local ? dlon : 0;
+    return local;
+}
+
+/* On the plane both use the cos of a latitude near the origin, from the one
+ * of the origin to the first order, where a cos per peer would otherwise be
+ * needed: t is its change to the latitude of the point. Under 10 km and up
+ * to 80 degrees of latitude that keeps the distance within 5 cm of the great
+ * circle and the bearing within 0.01 degree, see scripts/geodesy_bench.cpp */
+
+/* cm */
+template <typename T>
+static T plane_distance(const geodesy_origin_t& origin, T dlat, T dlon, T t)
+{
+    /* East is scaled with the cos of the mean latitude */
+    const T cos_mean = origin.cos_lat - t / 2;
+    const T north = dlat << GEODESY_DISTANCE_Q;
+    const T east = (dlon * cos_mean) >> (GEODESY_Q - GEODESY_DISTANCE_Q);
+    const T d = isqrt(north * north + east * east);
+    return (d * static_cast<int64_t>(GEODESY_CM_PER_UNIT_Q32) +
+            (1LL << 31)) >> 32;
+}
+
+/* Hundredths of a degree */
+template <typename T>
+static T plane_bearing(const geodesy_origin_t& origin, T dlat, T dlon, T t)
+{
+    /* The forward azimuth to the second order, the meridians converge
+     * towards the poles */
+    const T cos_lat2 = origin.cos_lat - t;
+    const T east = (dlon * cos_lat2) >> (GEODESY_Q - GEODESY_DISTANCE_Q);
+    const T sin_cos = (origin.sin_lat * cos_lat2) >> GEODESY_Q;
+    const T north = (dlat << GEODESY_DISTANCE_Q) +
+                    ((times_rad(sin_cos, dlon) * dlon) >>
+                     (GEODESY_Q + 1 - GEODESY_DISTANCE_Q));
+    return bearing_of(east, north);
+}
+
+static float degrees(int32_t coordinate)
+{
+    return static_cast<float>(coordinate) / ASTROLAVOS_COORDINATE_SCALE;
+}
+
+geodesy_origin_t geodesyOrigin(int32_t latitude, int32_t longitude)
+{
+    geodesy_origin_t origin;
+    origin.latitude = latitude;
+    origin.longitude = longitude;
+    trigSinCos(trigAngle(latitude, 360U * ASTROLAVOS_COORDINATE_SCALE),
+               origin.sin_lat, origin.cos_lat);
+    origin.local = std::abs(latitude) <= ASTROLAVOS_GEODESY_LOCAL_MAX_LATITUDE *
+                                             ASTROLAVOS_COORDINATE_SCALE;
+    return origin;
+}
+
+static uint32_t far_distance(const geodesy_origin_t& origin, int32_t latitude,
+                             int32_t longitude)
+{
+    return lroundf(100 * haversineDistance(degrees(origin.latitude),
+                                           degrees(origin.longitude),
+                                           degrees(latitude),
+                                           degrees(longitude)));
+}
+
+static uint16_t far_bearing(const geodesy_origin_t& origin, int32_t latitude,
+                            int32_t longitude)
+{
+    return lroundf(100 * forwardAzimuth(degrees(origin.latitude),
+                                        degrees(origin.longitude),
+                                        degrees(latitude),
+                                        degrees(longitude))) %
+           36000;
+}
+
+/* offset() of one point, with the reach of the plane of the origin */
+static bool local_offset(const geodesy_origin_t& origin, int32_t latitude,
+                         int32_t longitude, int64_t& dlat, int64_t& dlon)
+{
+    return origin.local &&
+           offset<int64_t>(origin, latitude, longitude, dlat, dlon);
+}
+
+uint32_t geodesyDistance(const geodesy_origin_t& origin, int32_t latitude,
+                         int32_t longitude)
+{
+    int64_t dlat, dlon;
+    if (!local_offset(origin, latitude, longitude, dlat, dlon))
+        return far_distance(origin, latitude, longitude);
+    return plane_distance(origin, dlat, dlon,
+                          times_rad(origin.sin_lat, dlat));
+}
+
+uint16_t geodesyBearing(const geodesy_origin_t& origin, int32_t latitude,
+                        int32_t longitude)
+{
+    int64_t dlat, dlon;
+    if (!local_offset(origin, latitude, longitude, dlat, dlon))
+        return far_bearing(origin, latitude, longitude);
+    return plane_bearing(origin, dlat, dlon,
+                         times_rad(origin.sin_lat, dlat));
+}
+
+geodesy_vector_t geodesyVector(const geodesy_origin_t& origin,
+                               int32_t latitude, int32_t longitude)
+{
+    int64_t dlat, dlon;
+    if (!local_offset(origin, latitude, longitude, dlat, dlon))
+        return {far_distance(origin, latitude, longitude),
+                far_bearing(origin, latitude, longitude)};
+    const int64_t t = times_rad(origin.sin_lat, dlat);
+    return {static_cast<uint32_t>(plane_distance(origin, dlat, dlon, t)),
+            static_cast<uint16_t>(plane_bearing(origin, dlat, dlon, t))};
+}
+
+static void store(const geodesy_batch_t& batch, size_t i,
+                  const geodesy_vector_t& vector, uint16_t heading,
+                  uint8_t sectors)
+{
+    batch.distance[i] = vector.distance;
+    batch.bearing[i] = vector.bearing;
+    if (!batch.sector || !sectors)
+        return;
+    /* Rounded to the nearest sector, as the arrows are */
+    const uint32_t relative = (vector.bearing + 36000 - heading) % 36000;
+    batch.sector[i] = (relative * sectors + 18000) / 36000 % sectors;
+}
+
+void geodesyBatch(const geodesy_origin_t& origin, uint16_t heading,
+                  uint8_t sectors, const geodesy_batch_t& batch)
+{
+    size_t i = 0;
+#if ASTROLAVOS_GEODESY_LANES > 1
+    constexpr size_t lanes = ASTROLAVOS_GEODESY_LANES;
+    for (; origin.local && i + lanes <= batch.n; i += lanes)
+    {
+        geodesy_lanes_t latitude, longitude, dlat, dlon;
+        for (size_t k = 0; k < lanes; k++)
+        {
+            latitude[k] = batch.latitude[i + k];
+            longitude[k] = batch.longitude[i + k];
+        }
+        const geodesy_lanes_t local =
+            offset(origin, latitude, longitude, dlat, dlon);
+        const geodesy_lanes_t t = times_rad(origin.sin_lat, dlat);
+        const geodesy_lanes_t distance = plane_distance(origin, dlat, dlon, t);
+        const geodesy_lanes_t bearing = plane_bearing(origin, dlat, dlon, t);
+        for (size_t k = 0; k < lanes; k++)
+        {
+            /* The lanes out of reach of the plane were measured at the
+             * origin, they fall back to Haversine one by one */
+            const geodesy_vector_t vector =
+                local[k] ? geodesy_vector_t{static_cast<uint32_t>(distance[k]),
+                                            static_cast<uint16_t>(bearing[k])}
+                         : geodesyVector(origin, batch.latitude[i + k],
+                                         batch.longitude[i + k]);
+            store(batch, i + k, vector, heading, sectors);
+        }
+    }
+#endif
+    for (; i < batch.n; i++)
+        store(batch, i,
+              geodesyVector(origin, batch.latitude[i], batch.longitude[i]),
+              heading, sectors);
+}
+
+float haversineDistance(float lat1, float lon1, float lat2, float lon2)
+{
+    lat1 *= GEODESY_DEG_TO_RAD;
+    lat2 *= GEODESY_DEG_TO_RAD;
+    const float dLat = lat2 - lat1;
+    const float dLon = (lon2 - lon1) * GEODESY_DEG_TO_RAD;
+
+    const float sinDLat = sinf(dLat / 2.0f);
+    const float sinDLon = sinf(dLon / 2.0f);
+
+    const float a_hav =
+        sinDLat * sinDLat + cosf(lat1) * cosf(lat2) * sinDLon * sinDLon;
+
+    const float c = 2.0f * atan2f(sqrtf(a_hav), sqrtf(1.0f - a_hav));
+    return EARTH_RADIUS_M * c;
+}
+
+float forwardAzimuth(float lat1, float lon1, float lat2, float lon2)
+{
+    lat1 *= GEODESY_DEG_TO_RAD;
+    lat2 *= GEODESY_DEG_TO_RAD;
+    const float dLon = (lon2 - lon1) * GEODESY_DEG_TO_RAD;
+
+    const float y = sinf(dLon) * cosf(lat2);
+    const float x =
+        cosf(lat1) * sinf(lat2) - sinf(lat1) * cosf(lat2) * cosf(dLon);
+
+    return fmodf(atan2f(y, x) * GEODESY_RAD_TO_DEG + 360.0f, 360.0f);
+}
+
+} // namespace astrolavos
@@ -0,0 +1,137 @@
+/**
+ * @file AstrolavosGeodesy.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Distance and bearing between two positions, on a plane tangent to
+ * our position for nearby peers and with Haversine for the others
+ * @version 0.1
+ * @date 2025-08-07
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef ASTROLAVOS_GEODESY_LOCAL_RANGE
+#define ASTROLAVOS_GEODESY_LOCAL_RANGE 10000 /* m covered by the plane */
+#endif
+
+#ifndef ASTROLAVOS_GEODESY_LOCAL_MAX_LATITUDE
+#define ASTROLAVOS_GEODESY_LOCAL_MAX_LATITUDE 80 /* degrees, Haversine above */
+#endif
+
+#ifndef ASTROLAVOS_GEODESY_LANES
+/* Peers geodesyBatch() measures at once with the GCC vector extensions, 1
+ * for scalar code. The target has no SIMD unit for the 64 bit lanes, on the
+ * host two of them fill an SSE2 or NEON register */
+#if defined(ESP_PLATFORM)
+#define ASTROLAVOS_GEODESY_LANES 1
+#else
+#define ASTROLAVOS_GEODESY_LANES 2
+#endif
+#endif
+
+namespace astrolavos
+{
+
+constexpr float EARTH_RADIUS_M = 6371000.0f; // Radius of the Earth in meters
+
+/* The terms of our position every peer needs, computed once per fix */
+typedef struct
+{
+    int32_t latitude;  /* 1e-7 degrees */
+    int32_t longitude; /* 1e-7 degrees */
+    int32_t cos_lat;   /* Q30 */
+    int32_t sin_lat;   /* Q30 */
+    bool local;        /* Far enough from the poles for the plane */
+} geodesy_origin_t;
+
+/* Where a point lies from the origin */
+typedef struct
+{
+    uint32_t distance; /* cm */
+    uint16_t bearing;  /* Hundredths of a degree [0, 36000) */
+} geodesy_vector_t;
+
+/* Peers as a structure of arrays, one array per field, for geodesyBatch() */
+typedef struct
+{
+    const int32_t* latitude;  /* 1e-7 degrees, known for all of them */
+    const int32_t* longitude; /* 1e-7 degrees */
+    uint32_t* distance;       /* cm */
+    uint16_t* bearing;        /* Hundredths of a degree [0, 36000) */
+    uint8_t* sector;          /* Relative to our heading, or nullptr */
+    size_t n;
+} geodesy_batch_t;
+
+/**
+ * @brief Compute the terms of our position, with one cos and one sin.
+ *
+ * @param latitude in 1e-7 degrees
+ * @param longitude in 1e-7 degrees
+ * @return geodesy_origin_t
+ */
+geodesy_origin_t geodesyOrigin(int32_t latitude, int32_t longitude);
+
+/**
+ * @brief Great circle distance from the origin to a point. Points within
+ * ASTROLAVOS_GEODESY_LOCAL_RANGE are measured on the plane tangent to the
+ * origin in integer arithmetic, the others with Haversine.
+ *
+ * @param origin
+ * @param latitude of the point in 1e-7 degrees
+ * @param longitude of the point in 1e-7 degrees
+ * @return uint32_t centimeters
+ */
+uint32_t geodesyDistance(const geodesy_origin_t& origin, int32_t latitude,
+                         int32_t longitude);
+
+/**
+ * @brief Initial bearing from the origin to a point, on the same plane as
+ * geodesyDistance() and with the forward azimuth outside of it.
+ *
+ * @return uint16_t hundredths of a degree [0, 36000)
+ */
+uint16_t geodesyBearing(const geodesy_origin_t& origin, int32_t latitude,
+                        int32_t longitude);
+
+/**
+ * @brief geodesyDistance() and geodesyBearing() of a point at once, sharing
+ * the terms they have in common.
+ *
+ * @return geodesy_vector_t
+ */
+geodesy_vector_t geodesyVector(const geodesy_origin_t& origin,
+                               int32_t latitude, int32_t longitude);
+
+/**
+ * @brief geodesyVector() of all the peers of a batch in one pass, in lanes
+ * of ASTROLAVOS_GEODESY_LANES, and the sector they lie in relative to our
+ * heading. The results are the same as one geodesyVector() per peer.
+ *
+ * @param origin
+ * @param heading our heading in hundredths of a degree
+ * @param sectors in a turn, sector 0 is straight ahead and they go
+ * clockwise. With 0 the sectors are not stored, as without batch.sector
+ * @param batch
+ */
+void geodesyBatch(const geodesy_origin_t& origin, uint16_t heading,
+                  uint8_t sectors, const geodesy_batch_t& batch);
+
+/**
+ * @brief Haversine distance between two positions in degrees.
+ *
+ * @return float meters
+ */
+float haversineDistance(float lat1, float lon1, float lat2, float lon2);
+
+/**
+ * @brief Forward azimuth from the first position to the second.
+ *
+ * @return float degrees [0, 360)
+ */
+float forwardAzimuth(float lat1, float lon1, float lat2, float lon2);
+
+} // namespace astrolavos
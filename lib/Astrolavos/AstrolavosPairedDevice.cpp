@@ -12,7 +12,6 @@
 #include "AstrolavosPairedDevice.hpp"
 #include "esp_log.h"
 #include "esp_timer.h"
-#include <cmath>
 #include <cstring>
 
 namespace astrolavos
@@ -28,17 +27,50 @@ AstrolavosPairedDevice::AstrolavosPairedDevice()
     _wants_to_meet = false;
     _is_active = false;
     _name[0] = '\0';
-    _coordinates.latitude = std::nanf("Not Initialised");
-    _coordinates.longitude = std::nanf("Not Initialised");
+    _coordinates.latitude = ASTROLAVOS_COORDINATE_UNKNOWN;
+    _coordinates.longitude = ASTROLAVOS_COORDINATE_UNKNOWN;
 }
 
 int AstrolavosPairedDevice::getId() { return _id; }
 
 void AstrolavosPairedDevice::updateDevice(const device_data_t& data)
 {
+    const bool moved = data.coordinates.latitude != _coordinates.latitude ||
+                       data.coordinates.longitude != _coordinates.longitude;
+    const bool changed = moved || data.wants_to_meet != _wants_to_meet;
     _coordinates = data.coordinates;
     _coordinates.ts = static_cast<uint32_t>(esp_timer_get_time());
     _wants_to_meet = data.wants_to_meet;
+    /* Bumped after the new position is in place, a getVector() running
+     * meanwhile caches it under the old generation and computes it again */
+    if (moved)
+        _position_generation++;
+    if (changed)
+        _generation++;
+}
+
+geodesy_vector_t
+AstrolavosPairedDevice::getVector(const geodesy_origin_t& origin,
+                                  uint32_t origin_generation)
+{
+    const uint32_t position_generation = _position_generation;
+    if (_vector_valid && _vector_origin_generation == origin_generation &&
+        _vector_position_generation == position_generation)
+        return _vector;
+    setVector(
+        geodesyVector(origin, _coordinates.latitude, _coordinates.longitude),
+        origin_generation, position_generation);
+    return _vector;
+}
+
+void AstrolavosPairedDevice::setVector(const geodesy_vector_t& vector,
+                                       uint32_t origin_generation,
+                                       uint32_t position_generation)
+{
+    _vector = vector;
+    _vector_origin_generation = origin_generation;
+    _vector_position_generation = position_generation;
+    _vector_valid = true;
 }
 
 gnss_location_t AstrolavosPairedDevice::getCoordinates()
@@ -53,8 +85,10 @@ void AstrolavosPairedDevice::configure(int id, uint16_t colour,
     _colour = colour;
     setName(name);
     _is_active = true;
-    _coordinates.latitude = std::nanf("Not Initialised");
-    _coordinates.longitude = std::nanf("Not Initialised");
+    _coordinates.latitude = ASTROLAVOS_COORDINATE_UNKNOWN;
+    _coordinates.longitude = ASTROLAVOS_COORDINATE_UNKNOWN;
+    _position_generation++;
+    _generation++;
 }
 
 void AstrolavosPairedDevice::setColour(uint16_t new_colour)
@@ -10,6 +10,7 @@
  */
 #pragma once
 
+#include "AstrolavosGeodesy.hpp"
 #include "Astrolavos_types.hpp"
 
 namespace astrolavos
@@ -32,6 +33,35 @@ public:
     void setActive(bool active);
     int getId();
     bool getWantsToMeet() const;
+    /** @brief Bumped whenever the position or the meet wish changes */
+    uint32_t getGeneration() const { return _generation; }
+
+    /**
+     * @brief Distance and bearing from our position. They are computed
+     * again only when our position or the one of the device changed since
+     * the last call, our heading does not change them.
+     *
+     * @param origin our position, the coordinates of the device must be
+     * known
+     * @param origin_generation changes with our position
+     * @return geodesy_vector_t
+     */
+    geodesy_vector_t getVector(const geodesy_origin_t& origin,
+                               uint32_t origin_generation);
+
+    /**
+     * @brief Fill the cache of getVector() with a result measured elsewhere.
+     *
+     * @param vector where the device lies from our position
+     * @param origin_generation of our position it was measured from
+     * @param position_generation getPositionGeneration() read before the
+     * coordinates it was measured to
+     */
+    void setVector(const geodesy_vector_t& vector, uint32_t origin_generation,
+                   uint32_t position_generation);
+
+    /** @brief Bumped after every change of the coordinates */
+    uint32_t getPositionGeneration() const { return _position_generation; }
 
 private:
     int _id;                      /* Unique identifier for the device */
@@ -41,6 +71,13 @@ private:
     bool _wants_to_meet; /* indicates whether this device wants to meet */
     bool _is_active; /* Is the device active? TODO: Do not show unused devices
                        future extension */
+    uint32_t _generation = 0; /* Changes of the displayed data */
+    uint32_t _position_generation = 0; /* Changes of _coordinates */
+    /* getVector() of the positions these generations were taken at */
+    geodesy_vector_t _vector = {};
+    uint32_t _vector_origin_generation = 0;
+    uint32_t _vector_position_generation = 0;
+    bool _vector_valid = false;
     /*TODO: Probably we will need more fields for LoRa */
 };
 
@@ -0,0 +1,155 @@
+/**
+ * @file AstrolavosRadar.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Radar view of the peers: us at the centre and the peers as dots
+ * around us, turned with our heading. Only the dots that moved are redrawn.
+ * @version 0.1
+ * @date 2025-08-05
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "AstrolavosRadar.hpp"
+#include <TinyGPS++.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace astrolavos
+{
+/* Pixels from the centre to a peer at the range */
+constexpr float ASTROLAVOS_RADAR_RADIUS = 26.0f;
+/* Closer peers are kept this far out, clear of our own dot */
+constexpr float ASTROLAVOS_RADAR_MIN_RADIUS = 5.0f;
+constexpr uint8_t ASTROLAVOS_RADAR_DOT = 4;    /* Side of a peer */
+constexpr uint8_t ASTROLAVOS_RADAR_FRAMED = 6; /* Side of a framed peer */
+constexpr uint8_t ASTROLAVOS_RADAR_SELF = 3;   /* Side of our dot */
+constexpr uint8_t ASTROLAVOS_RADAR_NORTH = 2;  /* Side of the north marker */
+/* Ranges of the radar in m, up to ASTROLAVOS_MAXIMUM_ACCEPTABLE_DISTANCE */
+constexpr uint16_t ASTROLAVOS_RADAR_RANGES[] = {25,   50,   100,  250, 500,
+                                                1000, 2500, 5000, 10000};
+
+static bool same(const radar_sprite_t& a, const radar_sprite_t& b)
+{
+    return a.x == b.x && a.y == b.y && a.size == b.size &&
+           a.color == b.color && a.frame == b.frame;
+}
+
+static bool overlap(const radar_sprite_t& a, const radar_sprite_t& b)
+{
+    return a.x < b.x + b.size && b.x < a.x + a.size && a.y < b.y + b.size &&
+           b.y < a.y + a.size;
+}
+
+void AstrolavosRadar::setPeer(int slot, float distance, float bearing,
+                              uint16_t color, uint16_t frame)
+{
+    if (slot < 0 || slot >= ASTROLAVOS_NUMBER_OF_DEVICES)
+        return;
+    _peers[slot] = {distance, bearing, color, frame, true};
+}
+
+void AstrolavosRadar::hidePeer(int slot)
+{
+    if (slot < 0 || slot >= ASTROLAVOS_NUMBER_OF_DEVICES)
+        return;
+    _peers[slot].shown = false;
+}
+
+radar_sprite_t AstrolavosRadar::sprite(float radius, float angle,
+                                       uint8_t size, uint16_t color,
+                                       uint16_t frame)
+{
+    const float rad = angle * static_cast<float>(DEG_TO_RAD);
+    radar_sprite_t s;
+    s.x = ASTROLAVOS_RADAR_X + lroundf(radius * sinf(rad)) - size / 2;
+    s.y = ASTROLAVOS_RADAR_Y - lroundf(radius * cosf(rad)) - size / 2;
+    s.size = size;
+    s.color = color;
+    s.frame = frame;
+    return s;
+}
+
+void AstrolavosRadar::draw(HT_st7735_renderer* renderer, float heading)
+{
+    float farthest = 0;
+    for (const radar_peer_t& peer : _peers)
+    {
+        if (peer.shown)
+            farthest = std::max(farthest, peer.distance);
+    }
+    constexpr size_t n_ranges =
+        sizeof(ASTROLAVOS_RADAR_RANGES) / sizeof(ASTROLAVOS_RADAR_RANGES[0]);
+    _range = ASTROLAVOS_RADAR_RANGES[n_ranges - 1];
+    for (uint16_t range : ASTROLAVOS_RADAR_RANGES)
+    {
+        if (range >= farthest)
+        {
+            _range = range;
+            break;
+        }
+    }
+
+    /* The top of the radar is where we are heading */
+    const float up = std::isnan(heading) ? 0.0f : heading;
+    radar_sprite_t next[SPRITES] = {};
+    for (int i = 0; i < ASTROLAVOS_NUMBER_OF_DEVICES; i++)
+    {
+        const radar_peer_t& peer = _peers[i];
+        if (!peer.shown)
+            continue;
+        const float radius =
+            std::max(ASTROLAVOS_RADAR_MIN_RADIUS,
+                     peer.distance / _range * ASTROLAVOS_RADAR_RADIUS);
+        if (peer.frame == ST7735_BLACK)
+            next[i] = sprite(radius, peer.bearing - up, ASTROLAVOS_RADAR_DOT,
+                             peer.color, peer.color);
+        else
+            next[i] = sprite(radius, peer.bearing - up,
+                             ASTROLAVOS_RADAR_FRAMED, peer.color, peer.frame);
+    }
+    /* North just outside the range, and us on top of everything else */
+    next[SPRITES - 2] = sprite(ASTROLAVOS_RADAR_RADIUS + 2, -up,
+                               ASTROLAVOS_RADAR_NORTH, ST7735_RED, ST7735_RED);
+    next[SPRITES - 1] = sprite(0, 0, ASTROLAVOS_RADAR_SELF, ST7735_WHITE,
+                               ST7735_WHITE);
+
+    bool changed[SPRITES];
+    radar_sprite_t erased[SPRITES];
+    int n_erased = 0;
+    for (int i = 0; i < SPRITES; i++)
+    {
+        changed[i] = !same(next[i], _drawn[i]);
+        if (!changed[i] || !_drawn[i].size)
+            continue;
+        const radar_sprite_t& old = _drawn[i];
+        renderer->fill_rectangle(old.x, old.y, old.size, old.size,
+                                 ST7735_BLACK);
+        erased[n_erased++] = old;
+    }
+    for (int i = 0; i < SPRITES; i++)
+    {
+        const radar_sprite_t& s = next[i];
+        if (!s.size)
+            continue;
+        /* An erased sprite may have taken a corner of one that stayed */
+        bool redraw = changed[i];
+        for (int j = 0; j < n_erased && !redraw; j++)
+            redraw = overlap(s, erased[j]);
+        if (!redraw)
+            continue;
+        if (s.frame == s.color)
+        {
+            renderer->fill_rectangle(s.x, s.y, s.size, s.size, s.color);
+        }
+        else
+        {
+            renderer->fill_rectangle(s.x, s.y, s.size, s.size, s.frame);
+            renderer->fill_rectangle(s.x + 1, s.y + 1, s.size - 2, s.size - 2,
+                                     s.color);
+        }
+    }
+    std::copy_n(next, SPRITES, _drawn);
+}
+
+} // namespace astrolavos
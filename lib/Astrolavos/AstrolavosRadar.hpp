@@ -0,0 +1,98 @@
+/**
+ * @file AstrolavosRadar.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Radar view of the peers: us at the centre and the peers as dots
+ * around us, turned with our heading. Only the dots that moved are redrawn.
+ * @version 0.1
+ * @date 2025-08-05
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include "Astrolavos_types.hpp"
+#include <HT_st7735_renderer.hpp>
+
+namespace astrolavos
+{
+
+/* Centre of the radar, in the middle of the rows of the peer list */
+constexpr int16_t ASTROLAVOS_RADAR_X = ST7735_WIDTH / 2;
+constexpr int16_t ASTROLAVOS_RADAR_Y =
+    (ST7735_TEXT_ROWS - 2) * ST7735_TEXT_CELL_HEIGHT / 2;
+
+/* A square drawn on the panel */
+typedef struct
+{
+    int16_t x, y;   /* Top left corner */
+    uint8_t size;   /* Side in pixels, 0 while not shown */
+    uint16_t color; /* Inside */
+    uint16_t frame; /* One pixel border, the same as color without one */
+} radar_sprite_t;
+
+class AstrolavosRadar
+{
+public:
+    /**
+     * @brief Place a peer on the radar, shown by the next draw().
+     *
+     * @param slot the device ID
+     * @param distance in meters
+     * @param bearing absolute heading to the peer in degrees
+     * @param color the colour of the peer
+     * @param frame border around the dot, ST7735_BLACK for none
+     */
+    void setPeer(int slot, float distance, float bearing, uint16_t color,
+                 uint16_t frame);
+
+    /** @brief Take a peer off the radar with the next draw() */
+    void hidePeer(int slot);
+
+    /**
+     * @brief Erase the sprites that moved or changed and draw them at their
+     * new place. The sprites that did not change are drawn again only if
+     * an erased one overlapped them.
+     *
+     * @param renderer
+     * @param heading our heading in degrees, the radar points north up while
+     * it is NaN
+     */
+    void draw(HT_st7735_renderer* renderer, float heading);
+
+    /**
+     * @brief Get the distance at the edge of the radar, it grows in steps
+     * to fit the farthest peer.
+     *
+     * @return uint16_t meters
+     */
+    uint16_t getRange() const { return _range; }
+
+private:
+    typedef struct
+    {
+        float distance;
+        float bearing;
+        uint16_t color;
+        uint16_t frame;
+        bool shown;
+    } radar_peer_t;
+
+    /**
+     * @brief The sprite of a point of the radar.
+     *
+     * @param radius pixels from the centre
+     * @param angle degrees clockwise from the top
+     */
+    static radar_sprite_t sprite(float radius, float angle, uint8_t size,
+                                 uint16_t color, uint16_t frame);
+
+    /* The peers, our position and the north marker */
+    static constexpr int SPRITES = ASTROLAVOS_NUMBER_OF_DEVICES + 2;
+
+    radar_peer_t _peers[ASTROLAVOS_NUMBER_OF_DEVICES] = {};
+    radar_sprite_t _drawn[SPRITES] = {}; /* As on the panel */
+    uint16_t _range = 0;
+};
+
+} // namespace astrolavos
@@ -0,0 +1,59 @@
+/**
+ * @file AstrolavosSplash.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Boot splash emblem, generated by scripts/rle_image.py.
+ * Do not edit, run the script instead.
+ * @version 0.1
+ * @date 2025-07-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "HT_st7735_image.hpp"
+
+namespace astrolavos
+{
+
+static const uint16_t astrolavos_splash_palette[] = {
+    0x0000, 0x07FF, 0xFFFF,
+};
+
+static const uint8_t astrolavos_splash_rle[] = {
+    0x0f, 0x22, 0x17, 0x0f, 0x09, 0x1d, 0x0f, 0x04, 0x14, 0x02, 0x21, 0x02,
+    0x14, 0x0f, 0x01, 0x13, 0x04, 0x21, 0x04, 0x13, 0x0d, 0x13, 0x21, 0x0b,
+    0x21, 0x13, 0x0a, 0x12, 0x02, 0x20, 0x0b, 0x21, 0x01, 0x12, 0x09, 0x11,
+    0x0f, 0x01, 0x22, 0x01, 0x11, 0x08, 0x11, 0x0f, 0x01, 0x22, 0x03, 0x11,
+    0x06, 0x12, 0x08, 0x15, 0x01, 0x21, 0x04, 0x12, 0x05, 0x11, 0x20, 0x06,
+    0x11, 0x05, 0x10, 0x21, 0x05, 0x20, 0x11, 0x04, 0x12, 0x21, 0x04, 0x10,
+    0x07, 0x22, 0x04, 0x21, 0x12, 0x03, 0x11, 0x06, 0x10, 0x08, 0x21, 0x00,
+    0x10, 0x06, 0x11, 0x03, 0x11, 0x05, 0x10, 0x08, 0x21, 0x02, 0x10, 0x05,
+    0x11, 0x02, 0x11, 0x06, 0x10, 0x07, 0x22, 0x02, 0x10, 0x06, 0x11, 0x01,
+    0x11, 0x05, 0x10, 0x08, 0x21, 0x04, 0x10, 0x05, 0x11, 0x01, 0x11, 0x05,
+    0x10, 0x05, 0x13, 0x05, 0x10, 0x05, 0x11, 0x01, 0x11, 0x21, 0x03, 0x10,
+    0x05, 0x13, 0x05, 0x10, 0x03, 0x21, 0x11, 0x01, 0x11, 0x21, 0x03, 0x10,
+    0x05, 0x13, 0x05, 0x10, 0x03, 0x21, 0x11, 0x01, 0x11, 0x05, 0x10, 0x05,
+    0x13, 0x05, 0x10, 0x05, 0x11, 0x01, 0x11, 0x05, 0x10, 0x04, 0x21, 0x08,
+    0x10, 0x05, 0x11, 0x01, 0x11, 0x06, 0x10, 0x02, 0x22, 0x07, 0x10, 0x06,
+    0x11, 0x02, 0x11, 0x05, 0x10, 0x02, 0x21, 0x08, 0x10, 0x05, 0x11, 0x03,
+    0x11, 0x06, 0x10, 0x00, 0x21, 0x08, 0x10, 0x06, 0x11, 0x03, 0x12, 0x21,
+    0x04, 0x22, 0x07, 0x10, 0x04, 0x21, 0x12, 0x04, 0x11, 0x20, 0x05, 0x21,
+    0x10, 0x05, 0x11, 0x06, 0x20, 0x11, 0x05, 0x12, 0x04, 0x21, 0x01, 0x15,
+    0x08, 0x12, 0x06, 0x11, 0x03, 0x22, 0x0f, 0x01, 0x11, 0x08, 0x11, 0x01,
+    0x22, 0x0f, 0x01, 0x11, 0x09, 0x12, 0x01, 0x21, 0x0b, 0x20, 0x02, 0x12,
+    0x0a, 0x13, 0x21, 0x0b, 0x21, 0x13, 0x0d, 0x13, 0x04, 0x21, 0x04, 0x13,
+    0x0f, 0x01, 0x14, 0x02, 0x21, 0x02, 0x14, 0x0f, 0x04, 0x1d, 0x0f, 0x09,
+    0x17, 0x0f, 0x22,
+};
+
+extern const st7735_image_t astrolavos_splash;
+const st7735_image_t astrolavos_splash = {
+    36,
+    36,
+    sizeof(astrolavos_splash_palette) / sizeof(uint16_t),
+    astrolavos_splash_palette,
+    astrolavos_splash_rle,
+    sizeof(astrolavos_splash_rle),
+};
+
+} // namespace astrolavos
@@ -0,0 +1,151 @@
+/**
+ * @file AstrolavosTrig.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Fixed point trigonometry with CORDIC: sin, cos and atan2 of binary
+ * angles, and the integer square root, for the heading and the geodesy
+ * without the float routines of libm
+ * @version 0.1
+ * @date 2025-08-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "AstrolavosTrig.hpp"
+
+namespace astrolavos
+{
+/* atan(2^-i) as binary angles, the angle of the CORDIC step i */
+constexpr trig_angle_t TRIG_STEPS[TRIG_MAX_ITERATIONS] = {
+    536870912, 316933406, 167458907, 85004756, 42667331, 21354465,
+    10679838,  5340245,   2670163,   1335087,  667544,   333772,
+    166886,    83443,     41722,     20861,    10430,    5215,
+    2608,      1304,      652,       326,      163,      81,
+    41,        20,        10,        5,        3,        1};
+/* 1 / the gain of all the steps, Q30. Fewer steps have a gain closer to 1,
+ * the difference is within the error of the last step */
+constexpr int32_t TRIG_GAIN_Q30 = 652032874;
+/* The vectors are scaled to this magnitude, the gain of the steps takes
+ * them under 2^31 */
+constexpr int TRIG_NORMAL_BITS = 28;
+
+static int steps(int iterations)
+{
+    if (iterations < 0)
+        return 0;
+    return iterations > TRIG_MAX_ITERATIONS ? TRIG_MAX_ITERATIONS
+                                            : iterations;
+}
+
+trig_angle_t trigAngle(int32_t value, uint32_t per_turn)
+{
+    const int64_t turns = static_cast<int64_t>(value) * (1LL << 32);
+    const int64_t half = per_turn / 2;
+    const int64_t angle = turns >= 0 ? (turns + half) / per_turn
+                                     : -((half - turns) / per_turn);
+    return static_cast<trig_angle_t>(angle);
+}
+
+uint16_t trigHundredths(trig_angle_t angle)
+{
+    return ((static_cast<uint64_t>(angle) * 36000 + (1ULL << 31)) >> 32) %
+           36000;
+}
+
+void trigSinCos(trig_angle_t angle, int32_t& sin, int32_t& cos,
+                int iterations)
+{
+    /* Into [-90, 90] degrees, the cos of the other half is negated */
+    int32_t z = static_cast<int32_t>(angle);
+    const bool back = z > static_cast<int32_t>(TRIG_QUARTER_TURN) ||
+                      z < -static_cast<int32_t>(TRIG_QUARTER_TURN);
+    if (back)
+        z = static_cast<int32_t>(TRIG_HALF_TURN - static_cast<uint32_t>(z));
+
+    int32_t x = TRIG_GAIN_Q30;
+    int32_t y = 0;
+    const int n = steps(iterations);
+    for (int i = 0; i < n; i++)
+    {
+        /* Towards z: counterclockwise while it is positive */
+        const int32_t m = z >> 31;
+        const int32_t dx = x >> i;
+        const int32_t dy = y >> i;
+        x -= (dy ^ m) - m;
+        y += (dx ^ m) - m;
+        z -= (static_cast<int32_t>(TRIG_STEPS[i]) ^ m) - m;
+    }
+    sin = y;
+    cos = back ? -x : x;
+}
+
+trig_angle_t trigAtan2(int32_t y, int32_t x, int iterations)
+{
+    if (!x && !y)
+        return 0;
+    /* Scale to TRIG_NORMAL_BITS, small vectors would lose the last steps */
+    int64_t vx = x;
+    int64_t vy = y;
+    const uint64_t ax = vx < 0 ? -vx : vx;
+    const uint64_t ay = vy < 0 ? -vy : vy;
+    const uint64_t magnitude = ax > ay ? ax : ay;
+    const int shift = __builtin_clzll(magnitude) - (63 - TRIG_NORMAL_BITS);
+    if (shift > 0)
+    {
+        vx *= 1LL << shift;
+        vy *= 1LL << shift;
+    }
+    else
+    {
+        vx >>= -shift;
+        vy >>= -shift;
+    }
+
+    /* Into the right half, the steps turn by less than 100 degrees */
+    trig_angle_t z = 0;
+    if (vx < 0)
+    {
+        vx = -vx;
+        vy = -vy;
+        z = TRIG_HALF_TURN;
+    }
+    int32_t cx = static_cast<int32_t>(vx);
+    int32_t cy = static_cast<int32_t>(vy);
+    const int n = steps(iterations);
+    for (int i = 0; i < n; i++)
+    {
+        /* Towards x: clockwise while y is positive */
+        const int32_t m = (cy - 1) >> 31;
+        const int32_t dx = cx >> i;
+        const int32_t dy = cy >> i;
+        cx += (dy ^ m) - m;
+        cy -= (dx ^ m) - m;
+        z += (TRIG_STEPS[i] ^ m) - m;
+    }
+    return z;
+}
+
+uint32_t trigSqrt(uint64_t v)
+{
+    if (!v)
+        return 0;
+    uint64_t root = 0;
+    /* The highest power of 4 in v */
+    uint64_t bit = 1ULL << ((63 - __builtin_clzll(v)) & ~1);
+    while (bit)
+    {
+        if (v >= root + bit)
+        {
+            v -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<uint32_t>(root);
+}
+
+} // namespace astrolavos
@@ -0,0 +1,78 @@
+/**
+ * @file AstrolavosTrig.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Fixed point trigonometry with CORDIC: sin, cos and atan2 of binary
+ * angles, and the integer square root, for the heading and the geodesy
+ * without the float routines of libm
+ * @version 0.1
+ * @date 2025-08-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+#pragma once
+
+#include <cstdint>
+
+#ifndef ASTROLAVOS_TRIG_ITERATIONS
+/* CORDIC steps by default, each adds about a bit: 30 is within 1e-8 */
+#define ASTROLAVOS_TRIG_ITERATIONS 30
+#endif
+
+namespace astrolavos
+{
+
+/* A whole turn is 2^32, so angles wrap around like the integer */
+typedef uint32_t trig_angle_t;
+
+constexpr trig_angle_t TRIG_QUARTER_TURN = 1UL << 30;
+constexpr trig_angle_t TRIG_HALF_TURN = 1UL << 31;
+constexpr int TRIG_MAX_ITERATIONS = 30;
+
+/**
+ * @brief The binary angle of a value in some unit of angle.
+ *
+ * @param value e.g. a latitude in 1e-7 degrees
+ * @param per_turn units in a turn, e.g. 3600000000
+ * @return trig_angle_t rounded to the nearest
+ */
+trig_angle_t trigAngle(int32_t value, uint32_t per_turn);
+
+/**
+ * @brief The hundredths of a degree of a binary angle.
+ *
+ * @return uint16_t [0, 36000)
+ */
+uint16_t trigHundredths(trig_angle_t angle);
+
+/**
+ * @brief sin and cos of an angle, rotating a vector in CORDIC steps.
+ *
+ * @param angle
+ * @param sin Q30
+ * @param cos Q30
+ * @param iterations the error halves with each, up to TRIG_MAX_ITERATIONS
+ */
+void trigSinCos(trig_angle_t angle, int32_t& sin, int32_t& cos,
+                int iterations = ASTROLAVOS_TRIG_ITERATIONS);
+
+/**
+ * @brief The angle of the vector (x, y) counterclockwise from x, turning it
+ * onto x in CORDIC steps.
+ *
+ * @param y
+ * @param x
+ * @param iterations the error halves with each, up to TRIG_MAX_ITERATIONS
+ * @return trig_angle_t 0 for the null vector
+ */
+trig_angle_t trigAtan2(int32_t y, int32_t x,
+                       int iterations = ASTROLAVOS_TRIG_ITERATIONS);
+
+/**
+ * @brief The square root, rounded down.
+ *
+ * @return uint32_t exact
+ */
+uint32_t trigSqrt(uint64_t v);
+
+} // namespace astrolavos
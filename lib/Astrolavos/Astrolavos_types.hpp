@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <climits>
 #include <cstddef>
 #include <cstdint>
 
@@ -18,8 +19,24 @@
 #define ASTROLAVOS_NUMBER_OF_DEVICES 4 // Default number of devices#
 #endif
 
+#ifndef ASTROLAVOS_PEER_SCROLL_PERIOD
+#define ASTROLAVOS_PEER_SCROLL_PERIOD 4000 /* ms between peer list scrolls */
+#endif
+
+#ifndef ASTROLAVOS_GLANCE_BATTERY_LOW
+#define ASTROLAVOS_GLANCE_BATTERY_LOW 15 /* % at which the display glances */
+#endif
+
+#ifndef ASTROLAVOS_DISPLAY_OFF_EXPECTED
+#define ASTROLAVOS_DISPLAY_OFF_EXPECTED 600 /* s, until an off period is seen */
+#endif
+
+#ifndef ASTROLAVOS_BACKLIGHT_POLICY
+#define ASTROLAVOS_BACKLIGHT_POLICY ASTROLAVOS_BACKLIGHT_AMBIENT
+#endif
+
 #ifndef ASTROLAVOS_MAGIC_CODE
-#define ASTROLAVOS_MAGIC_CODE 0xE7 /* Magic code to check validity */
+#define ASTROLAVOS_MAGIC_CODE 0xE8 /* Magic code, new with each wire format */
 #endif
 namespace astrolavos
 {
@@ -73,11 +90,18 @@ typedef struct
     /* TODO: Add LoRa Status */
 } health_status_t;
 
+/* Coordinates are fixed point, in units of 1e-7 degree (1.1 cm of latitude),
+ * from the NMEA sentences to the wire and the distance to the peers */
+constexpr int32_t ASTROLAVOS_COORDINATE_SCALE = 10000000; /* Units per degree */
+constexpr int32_t ASTROLAVOS_COORDINATE_UNKNOWN = INT32_MIN;
+constexpr int32_t ASTROLAVOS_LATITUDE_MAX = 90 * ASTROLAVOS_COORDINATE_SCALE;
+constexpr int32_t ASTROLAVOS_LONGITUDE_MAX = 180 * ASTROLAVOS_COORDINATE_SCALE;
+
 typedef struct
 {
-    float latitude;  /* Latitude in degrees or NaN if not available */
-    float longitude; /* Longitude in degrees or NaN if not available */
-    uint32_t ts;     /* Timestamp of the last update in usec */
+    int32_t latitude;  /* 1e-7 degrees or ASTROLAVOS_COORDINATE_UNKNOWN */
+    int32_t longitude; /* 1e-7 degrees or ASTROLAVOS_COORDINATE_UNKNOWN */
+    uint32_t ts;       /* Timestamp of the last update in usec */
 } gnss_location_t;
 
 typedef struct
@@ -88,16 +112,37 @@ typedef struct
 
 typedef enum
 {
-    ASTROLAVOS_DIRECTION_FRONT,
-    ASTROLAVOS_DIRECTION_FRONT_LEFT,
-    ASTROLAVOS_DIRECTION_LEFT,
-    ASTROLAVOS_DIRECTION_BACK_LEFT,
-    ASTROLAVOS_DIRECTION_BACK,
-    ASTROLAVOS_DIRECTION_BACK_RIGHT,
-    ASTROLAVOS_DIRECTION_RIGHT,
-    ASTROLAVOS_DIRECTION_FRONT_RIGHT,
-    ASTROLAVOS_DIRECTION_UNKNOWN
-} direction_t;
+    ASTROLAVOS_DISPLAY_FULL,   /* Full colour main screen */
+    ASTROLAVOS_DISPLAY_GLANCE, /* 8-colour partial strip with the essentials */
+    ASTROLAVOS_DISPLAY_OFF     /* Panel and backlight off */
+} display_profile_t;
+
+typedef enum
+{
+    ASTROLAVOS_BACKLIGHT_FIXED,   /* The level of the display profile */
+    ASTROLAVOS_BACKLIGHT_IDLE,    /* Dim while nothing on the screen changes */
+    ASTROLAVOS_BACKLIGHT_AMBIENT, /* Idle dimming plus a day/night curve */
+    ASTROLAVOS_BACKLIGHT_POLICY_COUNT
+} backlight_policy_t;
+
+/* Parts of the screen that are redrawn on their own */
+typedef enum
+{
+    ASTROLAVOS_WIDGET_HEALTH, /* Health bar */
+    ASTROLAVOS_WIDGET_IWTM,   /* Our I Want To Meet row */
+    ASTROLAVOS_WIDGET_GLANCE, /* The whole glance strip */
+    ASTROLAVOS_WIDGET_RADAR,  /* The radar taking the place of the peer list */
+    ASTROLAVOS_WIDGET_DEVICE, /* First of the peer rows, one per device */
+    ASTROLAVOS_WIDGET_COUNT =
+        ASTROLAVOS_WIDGET_DEVICE + ASTROLAVOS_NUMBER_OF_DEVICES
+} widget_t;
+
+typedef struct
+{
+    uint32_t generation; /* Sum of the generation counters of the inputs */
+    uint32_t stale;      /* Inputs that change with time alone */
+    bool drawn;          /* False until drawn in the current profile */
+} widget_state_t;
 
 typedef struct
 {
@@ -126,12 +171,17 @@ typedef struct
      * validate the authenticity/validity */
 } device_data_t;
 
-typedef struct
-{
-    uint8_t magic;         /* Magic Number to check validity */
-    uint8_t id;            /* Sender ID */
-    device_data_t payload; /* The actual Payload */
+constexpr uint8_t ASTROLAVOS_MESSAGE_WANTS_TO_MEET = 1 << 0;
 
+/* What goes over the air, 11 bytes without padding. Both ends are little
+ * endian */
+typedef struct __attribute__((packed))
+{
+    uint8_t magic;     /* Magic Number to check validity */
+    uint8_t id;        /* Sender ID */
+    uint8_t flags;     /* ASTROLAVOS_MESSAGE_* */
+    int32_t latitude;  /* 1e-7 degrees */
+    int32_t longitude; /* 1e-7 degrees */
 } application_message_t;
 
 /* TODO: Any LoRa Related Structs */
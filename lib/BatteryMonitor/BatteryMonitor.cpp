@@ -86,7 +86,8 @@ BatteryMonitor::BatteryMonitor(adc_channel_t channel)
     ESP_ERROR_CHECK(adc_oneshot_config_channel(_adc, _channel, &chan_cfg));
 }
 
-void BatteryMonitor::output_voltage(HT_st7735* display, float voltage)
+void BatteryMonitor::output_voltage(HT_st7735_renderer* renderer,
+                                    float voltage)
 {
     uint8_t percent = voltage_to_percent(voltage);
     ESP_LOGI(TAG, "Battery Voltage: %.2f V Percent=%u", voltage, percent);
@@ -97,8 +98,9 @@ void BatteryMonitor::output_voltage(HT_st7735* display, float voltage)
     static int Y = 80 - Font_7x10.height;
     char buf[5]; /* "xxx%" + NUL */
     snprintf(buf, sizeof(buf), "%u%%", percent);
-    display->fill_rectangle(X, Y, 160, 80, ST7735_BLACK);
-    display->write_str(X, Y, buf, Font_7x10, ST7735_WHITE, ST7735_BLACK);
+    renderer->fill_rectangle(X, Y, 160, 80, ST7735_BLACK);
+    renderer->write_str(X, Y, buf, Font_7x10, ST7735_WHITE, ST7735_BLACK);
+    renderer->end_frame();
 }
 
 int BatteryMonitor::get_raw()
@@ -119,11 +121,13 @@ float BatteryMonitor::get_voltage(int raw)
 void battery_task(void* args)
 {
     BatteryMonitor monitor;
-    HT_st7735* display = reinterpret_cast<HT_st7735*>(args);
+    HT_st7735_renderer* renderer =
+        reinterpret_cast<HT_st7735_renderer*>(args);
     ESP_LOGI(TAG, "Battery Monitor Task started");
     esp_pm_lock_handle_t lock;
     esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "battery_lock", &lock);
-    display->fill_rectangle(0, 0, 160, 80, ST7735_BLACK);
+    renderer->fill_screen(ST7735_BLACK);
+    renderer->end_frame();
 
     while (true)
     {
@@ -135,12 +139,10 @@ void battery_task(void* args)
         int raw = monitor.get_raw();
         float voltage = monitor.get_voltage(raw);
 
-        display->unhold_pins();
-        monitor.output_voltage(display, voltage);
+        monitor.output_voltage(renderer, voltage);
         gpio_hold_dis(heltec::PIN_ADC_CTRL);
         gpio_set_level(heltec::PIN_ADC_CTRL, 0);
         gpio_hold_en(heltec::PIN_ADC_CTRL);
-        display->hold_pins();
 
         ESP_LOGI(TAG, "Battery Voltage: %.2f V Raw=%d", voltage, raw);
         esp_pm_lock_release(lock);
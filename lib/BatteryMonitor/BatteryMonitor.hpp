@@ -11,7 +11,7 @@
 
 #pragma once
 
-#include "HT_st7735.hpp"
+#include "HT_st7735_renderer.hpp"
 #include "esp_adc/adc_oneshot.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -20,7 +20,7 @@ class BatteryMonitor
 {
 public:
     BatteryMonitor(adc_channel_t channel = ADC_CHANNEL_0);
-    void output_voltage(HT_st7735* display, float voltage);
+    void output_voltage(HT_st7735_renderer* renderer, float voltage);
     int get_raw();
     float get_voltage(int raw);
     uint8_t voltage_to_percent(float v);
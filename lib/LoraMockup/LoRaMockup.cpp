@@ -52,8 +52,9 @@ void loraMockupInitReceiver_task(void* args)
         astrolavos::gnss_location_t current_coords =
             astrolavos_app->getCoordinates();
 
-        if (std::isnan(current_coords.latitude) ||
-            std::isnan(current_coords.longitude))
+        constexpr int32_t unknown = astrolavos::ASTROLAVOS_COORDINATE_UNKNOWN;
+        if (current_coords.latitude == unknown ||
+            current_coords.longitude == unknown)
         {
             ESP_LOGW(TAG_RECEIVER,
                      "No valid coordinates available, waiting...");
@@ -82,8 +83,12 @@ void loraMockupInitReceiver_task(void* args)
         float lon_offset = MAX_OFFSET_DEGREES_LON * random_multiplier_lon;
 
         astrolavos::gnss_location_t random_coords;
-        random_coords.latitude = current_coords.latitude + lat_offset;
-        random_coords.longitude = current_coords.longitude + lon_offset;
+        random_coords.latitude =
+            current_coords.latitude +
+            lat_offset * astrolavos::ASTROLAVOS_COORDINATE_SCALE;
+        random_coords.longitude =
+            current_coords.longitude +
+            lon_offset * astrolavos::ASTROLAVOS_COORDINATE_SCALE;
         random_coords.ts = esp_timer_get_time();
 
         bool wants_to_meet =
@@ -97,10 +102,12 @@ void loraMockupInitReceiver_task(void* args)
         if (result == ESP_OK)
         {
             ESP_LOGI(TAG_RECEIVER,
-                     "Updated device %d coordinates: lat=%.6f, lon=%.6f, "
-                     "wants_to_meet=%s",
-                     target_device_id, random_coords.latitude,
-                     random_coords.longitude, wants_to_meet ? "true" : "false");
+                     "Updated device %d coordinates: lat=%ld, lon=%ld "
+                     "(1e-7 deg), wants_to_meet=%s",
+                     target_device_id,
+                     static_cast<long>(random_coords.latitude),
+                     static_cast<long>(random_coords.longitude),
+                     wants_to_meet ? "true" : "false");
         }
 
         else
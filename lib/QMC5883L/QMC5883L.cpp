@@ -12,13 +12,16 @@
 #include "esp_pm.h"
 #include "nvs_flash.h"
 #include <Astrolavos.hpp>
-#include <HT_st7735.hpp>
+#include <AstrolavosTrig.hpp>
+#include <HT_st7735_renderer.hpp>
 #include <algorithm>
 #include <limits>
 #include <math.h>
 #include <utils.hpp>
 
 constexpr size_t HEADING_TASK_SLEEP = 1000;
+/* CORDIC steps of the heading, within 0.002 degree */
+constexpr int QMC5883L_HEADING_ITERATIONS = 16;
 constexpr const char* TAG = "QMC5883L";
 
 #if defined(QMC5883L_USE_QMC5883L)
@@ -241,10 +244,10 @@ float QMC5883L::get_heading()
     int16_t x, y, z;
     if (read_calibrated(x, y, z) != ESP_OK)
         return NAN;
-    float angle = atan2f((float)y, (float)x) * 180.0f / M_PI;
-    if (angle < 0.0f)
-        angle += 360.0f;
-    return angle;
+    /* In fixed point, a hundredth of a degree is finer than the sensor */
+    return astrolavos::trigHundredths(
+               astrolavos::trigAtan2(y, x, QMC5883L_HEADING_ITERATIONS)) /
+           100.0f;
 }
 
 void heading_task(void* args)
@@ -252,7 +255,7 @@ void heading_task(void* args)
     esp_pm_lock_handle_t lock;
     esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "heading_lock", &lock);
     esp_pm_lock_acquire(lock);
-    HT_st7735* display = static_cast<HT_st7735*>(args);
+    HT_st7735_renderer* renderer = static_cast<HT_st7735_renderer*>(args);
     QMC5883L qmc5883l;
     int Y = 4 * Font_7x10.height;
 
@@ -271,21 +274,19 @@ void heading_task(void* args)
         {
             uint16_t heading = qmc5883l.get_heading();
             ESP_LOGI(TAG, "Heading: %u", heading);
-            display->unhold_pins();
-            display->fill_rectangle(0, Y, 180, Y + Font_7x10.height,
-                                    ST7735_BLACK);
+            renderer->fill_rectangle(0, Y, 180, Y + Font_7x10.height,
+                                     ST7735_BLACK);
             snprintf(buf, sizeof(buf), "%udeg", heading);
-            display->write_str(0, Y, buf, Font_7x10, ST7735_WHITE,
-                               ST7735_BLACK);
-            display->hold_pins();
+            renderer->write_str(0, Y, buf, Font_7x10, ST7735_WHITE,
+                                ST7735_BLACK);
+            renderer->end_frame();
         }
         else
         {
             ESP_LOGE(TAG, "Failed to read data");
-            display->unhold_pins();
-            display->write_str(0, Y, "Mag Failed", Font_7x10, ST7735_WHITE,
-                               ST7735_BLACK);
-            display->hold_pins();
+            renderer->write_str(0, Y, "Mag Failed", Font_7x10, ST7735_WHITE,
+                                ST7735_BLACK);
+            renderer->end_frame();
         }
         esp_pm_lock_release(lock);
         utils::delay_ms(HEADING_TASK_SLEEP); // Adjust delay as needed
@@ -18,7 +18,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <Astrolavos.hpp>
-#include <HT_st7735.hpp>
+#include <HT_st7735_renderer.hpp>
 #include <gnss.hpp>
 #include <pins.hpp>
 #include <utils.hpp>
@@ -32,6 +32,14 @@ constexpr size_t GNSS_TASK_LOCATED_SLEEP = 15 * 1000;
 constexpr size_t GNSS_TASK_SCANNING_SLEEP = 1 * 1000;
 constexpr size_t GNSS_POWER_UP_SLEEP = 3 * 1000;
 
+/* The NMEA degrees in 1e-7 degrees, without going through double */
+static int32_t to_coordinate(const RawDegrees& raw)
+{
+    const int32_t units = raw.deg * astrolavos::ASTROLAVOS_COORDINATE_SCALE +
+                          (raw.billionths + 50) / 100;
+    return raw.negative ? -units : units;
+}
+
 void gnss_power_up()
 {
     gpio_set_level(heltec::PIN_GNSS_RST, 1);
@@ -50,7 +58,8 @@ void gnss_task(void* args)
     esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "gnss_lock", &lock);
     esp_pm_lock_acquire(lock);
     utils::delay_ms(1000);
-    HT_st7735* display = reinterpret_cast<HT_st7735*>(args);
+    HT_st7735_renderer* renderer =
+        reinterpret_cast<HT_st7735_renderer*>(args);
 
     uart_config_t uart_config = {.baud_rate = 115200,
                                  .data_bits = UART_DATA_8_BITS,
@@ -83,23 +92,21 @@ void gnss_task(void* args)
                      gps.location.lng());
 
             ESP_LOGI(TAG, "%s", buffer);
-            display->unhold_pins();
-            display->fill_rectangle(0, 0, 180, 28, ST7735_BLACK);
-            display->write_str(0, 0, buffer, Font_7x10, ST7735_WHITE,
-                               ST7735_BLACK);
+            renderer->fill_rectangle(0, 0, 180, 28, ST7735_BLACK);
+            renderer->write_str(0, 0, buffer, Font_7x10, ST7735_WHITE,
+                                ST7735_BLACK);
+            renderer->end_frame();
             gnss_power_down();
-            display->hold_pins();
             esp_pm_lock_release(lock);
             utils::delay_ms(GNSS_TASK_LOCATED_SLEEP);
         }
         else
         {
-            display->unhold_pins();
-            display->fill_rectangle(0, 0, 180, 28, ST7735_BLACK);
-            display->write_str(0, 0, "Waiting for GNSS Data", Font_7x10,
-                               ST7735_WHITE, ST7735_BLACK);
+            renderer->fill_rectangle(0, 0, 180, 28, ST7735_BLACK);
+            renderer->write_str(0, 0, "Waiting for GNSS Data", Font_7x10,
+                                ST7735_WHITE, ST7735_BLACK);
+            renderer->end_frame();
             ESP_LOGI(TAG, "Waiting for GNSS data... %d bytes", len);
-            display->hold_pins();
             esp_pm_lock_release(lock);
             utils::delay_ms(GNSS_TASK_SCANNING_SLEEP);
         }
@@ -137,19 +144,25 @@ void gnss_astrolavos_task(void* args)
         for (int i = 0; i < len; i++)
             gps.encode(data[i]);
 
+        /* The time is valid before a position fix is */
+        if (gps.time.isUpdated() && gps.time.isValid())
+            astrolavos_app->updateTime(gps.time.hour(), gps.time.minute());
+
         if (gps.location.isUpdated())
         {
+            const astrolavos::gnss_location_t location = {
+                to_coordinate(gps.location.rawLat()),
+                to_coordinate(gps.location.rawLng()),
+                static_cast<uint32_t>(esp_timer_get_time())};
             ESP_LOGI(TAG,
                      "GNSS Data Updated,Num Satellites: %lu, "
-                     "Lat: %.5f, Lon: %.5f",
-                     gps.satellites.value(), gps.location.lat(),
-                     gps.location.lng());
+                     "Lat: %ld, Lon: %ld (1e-7 deg)",
+                     gps.satellites.value(),
+                     static_cast<long>(location.latitude),
+                     static_cast<long>(location.longitude));
             astrolavos_app->updateHealthGNSS(
                 static_cast<uint8_t>(gps.satellites.value()));
-            astrolavos_app->updateCoordinates(
-                {static_cast<float>(gps.location.lat()),
-                 static_cast<float>(gps.location.lng()),
-                 static_cast<uint32_t>(esp_timer_get_time())});
+            astrolavos_app->updateCoordinates(location);
             gnss_power_down();
             esp_pm_lock_release(lock);
             utils::delay_ms(astrolavos_app->getSleepDuration()->gnss);
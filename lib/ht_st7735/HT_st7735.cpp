@@ -14,16 +14,29 @@
 #include "HT_st7735.hpp"
 #include "HT_st7735_commands.hpp"
 #include "driver/gpio.h"
+#include "esp_attr.h"
 #include "esp_log.h"
+#include "esp_memory_utils.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <algorithm>
 #include <utils.hpp>
 
 static const char* TAG = "st7735";
 
+/* Runs right before every transaction, polling or queued, and drives DC */
+static void IRAM_ATTR st7735_pre_transfer(spi_transaction_t* t)
+{
+    const st7735_dc_t* dc = static_cast<const st7735_dc_t*>(t->user);
+    gpio_set_level(dc->pin, dc->level);
+}
+
 esp_err_t HT_st7735::init()
 {
     _mutex = xSemaphoreCreateMutex();
+    _dc_cmd = {_dc, 0};
+    _dc_data = {_dc, 1};
     gpio_config_t io = {};
     io.mode = GPIO_MODE_OUTPUT;
     io.pin_bit_mask =
@@ -47,15 +60,33 @@ esp_err_t HT_st7735::init()
     dev.clock_speed_hz = 26 * 1000 * 1000; // 26 MHz (40 MHz max for ST7735)
     dev.mode = 0;
     dev.spics_io_num = -1; // manual CS
-    dev.queue_size = 7;
+    dev.queue_size = ST7735_QUEUE_SIZE;
+    dev.pre_cb = st7735_pre_transfer;
     ESP_ERROR_CHECK(spi_bus_add_device(SPI3_HOST, &dev, &_spi));
 
+    _line_buf = static_cast<uint16_t*>(heap_caps_malloc(
+        ST7735_LINE_BUF_PIXELS * sizeof(uint16_t), MALLOC_CAP_DMA));
+    if (!_line_buf)
+    {
+        ESP_LOGE(TAG, "Failed to allocate the line buffer");
+        return ESP_ERR_NO_MEM;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
     select();
     reset();
     exec_cmd_list(init_cmds1);
+    exec_cmd_list(config_cmds);
     exec_cmd_list(init_cmds2);
+    exec_cmd_list(gamma_cmds);
     exec_cmd_list(init_cmds3);
     unselect();
+    xSemaphoreGive(_mutex);
+    _colmod = ST7735_COLMOD_16; /* Set by config_cmds */
+#ifdef ST7735_IS_160X80
+    _inverted = true; /* By init_cmds2 */
+#endif
+    _power_ts = _sleep_ts = esp_timer_get_time();
 
     // --- add just after gpio_set_level(_led, 1);
     ledc_timer_config_t tcfg = {
@@ -76,6 +107,8 @@ esp_err_t HT_st7735::init()
                                   .hpoint = 0,
                                   .sleep_mode = LEDC_SLEEP_MODE_KEEP_ALIVE};
     ESP_ERROR_CHECK(ledc_channel_config(&ccfg));
+    /* Fades are run by the LEDC hardware, only their end raises an interrupt */
+    ESP_ERROR_CHECK(ledc_fade_func_install(0));
 
     ESP_LOGI(TAG, "ST7735 initialised (%ux%u)", _width, _height);
     return ESP_OK;
@@ -87,32 +120,146 @@ void HT_st7735::reset()
     utils::delay_ms(5);
     gpio_set_level(_rst, 1);
     utils::delay_ms(150);
+    _window_valid = false;
 }
 
 inline void HT_st7735::cmd(uint8_t c)
 {
-    gpio_set_level(_dc, 0);
-    spi_transaction_t t = {};
-    t.flags = SPI_TRANS_USE_TXDATA;
-    t.length = 8;
-    t.tx_data[0] = c;
-    ESP_ERROR_CHECK(spi_device_polling_transmit(_spi, &t));
+    _stats.commands++;
+    transfer(&c, 1, &_dc_cmd);
 }
 
 inline void HT_st7735::data(const uint8_t* d, size_t len)
+{
+    transfer(d, len, &_dc_data);
+}
+
+void HT_st7735::transfer(const uint8_t* d, size_t len, const st7735_dc_t* dc)
 {
     if (!len)
         return;
-    gpio_set_level(_dc, 1);
-    spi_transaction_t t = {};
-    t.length = len * 8;
-    t.tx_buffer = d;
-    ESP_ERROR_CHECK(spi_device_polling_transmit(_spi, &t));
+    if (_async && _in_flight == ST7735_QUEUE_SIZE)
+        reap();
+    _stats.transactions++;
+    _stats.bytes += len;
+
+    spi_transaction_t* t = &_trans[_next_trans];
+    *t = {};
+    t->length = len * 8;
+    t->user = const_cast<st7735_dc_t*>(dc);
+    if (len <= sizeof(t->tx_data))
+    {
+        /* Small payloads travel inside the descriptor, so the caller's
+         * buffer does not need to outlive the transfer */
+        t->flags = SPI_TRANS_USE_TXDATA;
+        memcpy(t->tx_data, d, len);
+    }
+    else
+    {
+        t->tx_buffer = d;
+    }
+
+    if (!_async)
+    {
+        ESP_ERROR_CHECK(spi_device_polling_transmit(_spi, t));
+        return;
+    }
+    _next_trans = (_next_trans + 1) % ST7735_QUEUE_SIZE;
+    ESP_ERROR_CHECK(spi_device_queue_trans(_spi, t, portMAX_DELAY));
+    _in_flight++;
+    _seq_queued++;
 }
 
-void HT_st7735::exec_cmd_list(const uint8_t* a)
+void HT_st7735::reap()
+{
+    spi_transaction_t* done;
+    int64_t start = esp_timer_get_time();
+    ESP_ERROR_CHECK(spi_device_get_trans_result(_spi, &done, portMAX_DELAY));
+    _stats.blocked_us += esp_timer_get_time() - start;
+    _in_flight--;
+    _seq_done++;
+}
+
+void HT_st7735::fence()
+{
+    while (_in_flight)
+        reap();
+}
+
+uint16_t* HT_st7735::next_strip(size_t& capacity)
+{
+    if (!_async)
+    {
+        capacity = ST7735_LINE_BUF_PIXELS;
+        return _line_buf;
+    }
+    /* Ping-pong between the two halves of the line buffer, so that a strip
+     * is expanded while the previous one is still being clocked out */
+    _strip ^= 1;
+    while (_seq_done < _strip_seq[_strip])
+        reap();
+    capacity = ST7735_LINE_BUF_PIXELS / 2;
+    return _line_buf + _strip * capacity;
+}
+
+/* Pack an even number of pixels, in panel byte order, into RGB444 in place.
+ * Each pair is read before its 3 bytes are written and the output never
+ * catches up with the input */
+static size_t st7735_pack444(uint16_t* pixels, size_t n)
+{
+    uint8_t* out = reinterpret_cast<uint8_t*>(pixels);
+    for (size_t i = 0; i + 1 < n; i += 2)
+    {
+        const uint16_t a = HT_st7735::swap565(pixels[i]);
+        const uint16_t b = HT_st7735::swap565(pixels[i + 1]);
+        *out++ = ((a >> 8) & 0xF0) | ((a >> 7) & 0x0F);
+        *out++ = ((a << 3) & 0xF0) | (b >> 12);
+        *out++ = ((b >> 3) & 0xF0) | ((b >> 1) & 0x0F);
+    }
+    return n / 2 * 3;
+}
+
+uint16_t HT_st7735::strip_rows(size_t capacity, uint16_t w,
+                               uint16_t left) const
+{
+    /* RGB444 packs pixels in pairs, only the last strip of an area may end
+     * on half of one */
+    uint16_t rows = std::min<size_t>(capacity / w, left);
+    if (rows < left && (rows * w) & 1)
+        rows--;
+    return rows;
+}
+
+void HT_st7735::send_strip(uint16_t* strip, size_t pixels)
+{
+    const size_t bytes =
+        _colmod == ST7735_COLMOD_12 ? st7735_pack444(strip, pixels)
+                                    : pixels * 2;
+    data(reinterpret_cast<const uint8_t*>(strip), bytes);
+    _strip_seq[_strip] = _seq_queued;
+}
+
+void HT_st7735::set_pixel_format(st7735_pixel_format_t format)
 {
     xSemaphoreTake(_mutex, portMAX_DELAY);
+    /* COLMOD is sent with the next address window that can use it */
+    _format = format;
+    xSemaphoreGive(_mutex);
+}
+
+void HT_st7735::set_async(bool enable)
+{
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    fence();
+    _async = enable;
+    xSemaphoreGive(_mutex);
+}
+
+void HT_st7735::exec_cmd_list(const uint8_t* a)
+{
+    /* The caller holds the mutex. The lists may set the address window
+     * themselves */
+    _window_valid = false;
     uint8_t nCmd = *a++;
     while (nCmd--)
     {
@@ -128,30 +275,65 @@ void HT_st7735::exec_cmd_list(const uint8_t* a)
             ms = *a++;
             if (ms == 255)
                 ms = 500;
+            fence();
             utils::delay_ms(ms);
         }
     }
-    xSemaphoreGive(_mutex);
 }
 
 void HT_st7735::addr_window(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1)
 {
-    cmd(0x2A /*CASET*/);
-    uint8_t d1[] = {0x00, (uint8_t)(x0 + _x_start), 0x00,
-                    (uint8_t)(x1 + _x_start)};
-    data(d1, 4);
-    cmd(0x2B /*RASET*/);
-    uint8_t d2[] = {0x00, (uint8_t)(y0 + _y_start), 0x00,
-                    (uint8_t)(y1 + _y_start)};
-    data(d2, 4);
-    cmd(0x2C /*RAMWR*/);
+    /* The panel keeps the column and row ranges until they are set again,
+     * so only the ones that change are sent. RAMWR is always needed, it moves
+     * the write pointer back to the start of the window. The pixel format
+     * follows the same rule */
+    const uint8_t colmod =
+        packs((x1 - x0 + 1) * (y1 - y0 + 1)) ? ST7735_COLMOD_12
+                                             : ST7735_COLMOD_16;
+    if (_colmod != colmod)
+    {
+        cmd(ST7735_COLMOD);
+        data(&colmod, 1);
+        _colmod = colmod;
+    }
+    if (!_window_valid || _window.x0 != x0 || _window.x1 != x1)
+    {
+        cmd(ST7735_CASET);
+        uint8_t d1[] = {0x00, (uint8_t)(x0 + _x_start), 0x00,
+                        (uint8_t)(x1 + _x_start)};
+        data(d1, 4);
+    }
+    else
+    {
+        _stats.skipped++;
+    }
+    if (!_window_valid || _window.y0 != y0 || _window.y1 != y1)
+    {
+        cmd(ST7735_RASET);
+        uint8_t d2[] = {0x00, (uint8_t)(y0 + _y_start), 0x00,
+                        (uint8_t)(y1 + _y_start)};
+        data(d2, 4);
+    }
+    else
+    {
+        _stats.skipped++;
+    }
+    cmd(ST7735_RAMWR);
+    _window = {x0, y0, x1, y1};
+    _window_valid = true;
 }
 
 void HT_st7735::draw_pixel(uint16_t x, uint16_t y, uint16_t col)
 {
-    xSemaphoreTake(_mutex, portMAX_DELAY);
     if (x >= _width || y >= _height)
         return;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (_fb)
+    {
+        fb_fill(x, y, 1, 1, col);
+        xSemaphoreGive(_mutex);
+        return;
+    }
     select();
     addr_window(x, y, x, y);
     uint8_t d[] = {(uint8_t)(col >> 8), (uint8_t)col};
@@ -163,16 +345,37 @@ void HT_st7735::draw_pixel(uint16_t x, uint16_t y, uint16_t col)
 void HT_st7735::write_char(uint16_t x, uint16_t y, char ch, FontDef f,
                            uint16_t col, uint16_t bg)
 {
-    addr_window(x, y, x + f.width - 1, y + f.height - 1);
-    for (uint32_t i = 0; i < f.height; i++)
+    if (_fb)
     {
-        uint32_t row = f.data[(ch - 32) * f.height + i];
-        for (uint32_t j = 0; j < f.width; j++)
-        {
-            uint16_t c = ((row << j) & 0x8000) ? col : bg;
-            uint8_t d[] = {(uint8_t)(c >> 8), (uint8_t)c};
-            data(d, 2);
-        }
+        fb_char(x, y, ch, f, col, bg);
+        return;
+    }
+    write_glyphs(x, y, &ch, 1, f, col, bg);
+}
+
+void HT_st7735::write_glyphs(uint16_t x, uint16_t y, const char* s, size_t n,
+                             const FontDef& f, uint16_t col, uint16_t bg)
+{
+    /* ST7735_MAX_GLYPH_RUN covers a full row of the narrowest font */
+    n = std::min(n, ST7735_MAX_GLYPH_RUN);
+    const uint16_t w = n * f.width;
+    const uint16_t h = std::min<uint16_t>(f.height, _height - y);
+    addr_window(x, y, x + w - 1, y + h - 1);
+
+    /* Compose the run into strips so that it goes out in as few
+     * transactions as possible */
+    const uint16_t fg_c = swap565(col);
+    const uint16_t bg_c = swap565(bg);
+    uint16_t rows;
+    for (uint16_t row = 0; row < h; row += rows)
+    {
+        size_t capacity;
+        uint16_t* strip = next_strip(capacity);
+        rows = strip_rows(capacity, w, h - row);
+        for (size_t k = 0; k < n; k++)
+            f.blit(st7735_glyph(f, s[k]), row, rows, fg_c, bg_c,
+                   strip + k * f.width, w);
+        send_strip(strip, rows * w);
     }
 }
 
@@ -200,9 +403,23 @@ void HT_st7735::write_str(uint16_t x, uint16_t y, const char* s, FontDef f,
             if (y + f.height > _height)
                 break;
         }
-        write_char(x, y, *s, f, col, bg);
-        x += f.width;
-        ++s;
+        /* Collect every character that still fits on this text row */
+        size_t n = 0;
+        while (s[n] && s[n] != '\n' && x + (n + 1) * f.width <= _width)
+            n++;
+        if (!n)
+            break;
+        if (_fb)
+        {
+            for (size_t k = 0; k < n; k++)
+                fb_char(x + k * f.width, y, s[k], f, col, bg);
+        }
+        else
+        {
+            write_glyphs(x, y, s, n, f, col, bg);
+        }
+        x += n * f.width;
+        s += n;
     }
     unselect();
     xSemaphoreGive(_mutex);
@@ -218,44 +435,132 @@ void HT_st7735::fill_rectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
     if (y + h > _height)
         h = _height - y;
     xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (_fb)
+    {
+        fb_fill(x, y, w, h, col);
+        xSemaphoreGive(_mutex);
+        return;
+    }
     select();
     addr_window(x, y, x + w - 1, y + h - 1);
     uint32_t pixels = w * h;
-    const uint32_t max_buf = 256;
-    uint8_t buf[max_buf * 2];
-    for (uint32_t i = 0; i < max_buf; ++i)
-    {
-        buf[2 * i] = (uint8_t)(col >> 8);
-        buf[2 * i + 1] = (uint8_t)col;
-    }
-    gpio_set_level(_dc, 1);
+    const uint32_t max_buf = std::min<uint32_t>(pixels, ST7735_LINE_BUF_PIXELS);
+    std::fill_n(_line_buf, max_buf, swap565(col));
+    /* In RGB444 both counts are even, every chunk is whole pairs */
+    const bool packed = _colmod == ST7735_COLMOD_12;
+    if (packed)
+        st7735_pack444(_line_buf, max_buf);
     while (pixels)
     {
         uint32_t chunk = (pixels > max_buf) ? max_buf : pixels;
-        data(buf, chunk * 2);
+        data(reinterpret_cast<const uint8_t*>(_line_buf),
+             packed ? chunk / 2 * 3 : chunk * 2);
         pixels -= chunk;
     }
     unselect();
     xSemaphoreGive(_mutex);
 }
 
+/* Pixels stored uncompressed outside of DMA capable memory, they are copied
+ * through the line buffer */
+class st7735_copy_source
+{
+public:
+    explicit st7735_copy_source(const uint16_t* pixels) : _pixels(pixels) {}
+    size_t read(uint16_t* dst, size_t n)
+    {
+        memcpy(dst, _pixels, n * sizeof(uint16_t));
+        _pixels += n;
+        return n;
+    }
+
+private:
+    const uint16_t* _pixels;
+};
+
+template <typename Source>
+void HT_st7735::draw_strips(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                            Source& src)
+{
+    /* The caller holds the mutex and checked that the area is on screen */
+    if (!_fb)
+    {
+        select();
+        addr_window(x, y, x + w - 1, y + h - 1);
+    }
+    uint16_t rows;
+    for (uint16_t row = 0; row < h; row += rows)
+    {
+        size_t capacity;
+        uint16_t* strip = next_strip(capacity);
+        rows = strip_rows(capacity, w, h - row);
+        src.read(strip, rows * w);
+        if (_fb)
+            fb_image(x, y + row, w, rows, strip);
+        else
+            send_strip(strip, rows * w);
+    }
+    if (!_fb)
+        unselect();
+}
+
 void HT_st7735::draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                            const uint16_t* img)
 {
+    if (x >= _width || y >= _height || x + w - 1 >= _width ||
+        y + h - 1 >= _height)
+        return;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (_fb)
+    {
+        fb_image(x, y, w, h, img);
+    }
+    else if (esp_ptr_dma_capable(img) && !packs(w * h))
+    {
+        select();
+        addr_window(x, y, x + w - 1, y + h - 1);
+        data(reinterpret_cast<const uint8_t*>(img), w * h * 2);
+        unselect();
+    }
+    else
+    {
+        /* The SPI driver would otherwise allocate a DMA copy of the whole
+         * image, e.g. for images in flash. RGB444 is packed in the strips */
+        st7735_copy_source src(img);
+        draw_strips(x, y, w, h, src);
+    }
+    xSemaphoreGive(_mutex);
+}
+
+void HT_st7735::draw_image(uint16_t x, uint16_t y, const st7735_image_t& img)
+{
+    const uint16_t w = img.width, h = img.height;
+    if (x >= _width || y >= _height || x + w - 1 >= _width ||
+        y + h - 1 >= _height)
+        return;
     xSemaphoreTake(_mutex, portMAX_DELAY);
+    st7735_image_decoder src(img);
+    draw_strips(x, y, w, h, src);
+    xSemaphoreGive(_mutex);
+}
+
+void HT_st7735::draw_sprite(uint16_t x, uint16_t y, const st7735_sprite_t& sp,
+                            uint16_t col, uint16_t bg)
+{
+    const uint16_t w = sp.width, h = sp.height;
     if (x >= _width || y >= _height || x + w - 1 >= _width ||
         y + h - 1 >= _height)
         return;
-    select();
-    addr_window(x, y, x + w - 1, y + h - 1);
-    data(reinterpret_cast<const uint8_t*>(img), w * h * 2);
-    unselect();
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    st7735_rle_decoder src(sp, swap565(col), swap565(bg));
+    draw_strips(x, y, w, h, src);
     xSemaphoreGive(_mutex);
 }
 
 void HT_st7735::invert_colors(bool inv)
 {
     xSemaphoreTake(_mutex, portMAX_DELAY);
+    _inverted = inv;
     select();
     cmd(inv ? 0x21 /*INVON*/ : 0x20 /*INVOFF*/);
     unselect();
@@ -264,6 +569,7 @@ void HT_st7735::invert_colors(bool inv)
 void HT_st7735::set_gamma(uint8_t g)
 {
     xSemaphoreTake(_mutex, portMAX_DELAY);
+    _gamma = g;
     select();
     cmd(0x26 /*GAMSET*/);
     data(&g, 1);
@@ -291,34 +597,502 @@ void HT_st7735::unhold_pins()
         gpio_hold_dis(_vtft);
 }
 
-void HT_st7735::set_backlight(uint8_t percent)
+void HT_st7735::set_backlight(uint8_t percent, uint32_t fade_ms)
 {
     if (percent > 100)
         percent = 100;
+    _backlight = percent;
     uint32_t duty = ((uint32_t)percent * ((1 << LEDC_RES_BITS) - 1)) / 100;
-    ledc_set_duty(LEDC_MODE, LEDC_CH, duty);
-    ledc_update_duty(LEDC_MODE, LEDC_CH);
+    /* The thread safe variants take over from a fade still in progress */
+    if (fade_ms)
+        ledc_set_fade_time_and_start(LEDC_MODE, LEDC_CH, duty, fade_ms,
+                                     LEDC_FADE_NO_WAIT);
+    else
+        ledc_set_duty_and_update(LEDC_MODE, LEDC_CH, duty, 0);
 }
 
-void HT_st7735::turn_off()
+static const char* const power_names[ST7735_POWER_STATES] = {
+    "on", "dim", "display off", "sleep", "VTFT off"};
+
+void HT_st7735::set_power(st7735_power_t state)
 {
+    const int64_t now = esp_timer_get_time();
+    _power_stats.time_us[_power] += now - _power_ts;
+    _power_ts = now;
+    _power = state;
+}
+
+void HT_st7735::turn_off(st7735_power_t state)
+{
+    if (state == ST7735_POWER_VTFT_OFF && (!_fb || _vtft == GPIO_NUM_NC))
+        state = ST7735_POWER_SLEEP; /* Nothing to repaint from */
+    if (state < ST7735_POWER_DISPOFF || state >= ST7735_POWER_STATES ||
+        state <= _power)
+        return;
+    if (_power < ST7735_POWER_DISPOFF)
+        ledc_set_duty_and_update(LEDC_MODE, LEDC_CH, 0, 0);
+    unhold_pins();
     xSemaphoreTake(_mutex, portMAX_DELAY);
     select();
-    cmd(ST7735_DISPOFF);
+    if (_power < ST7735_POWER_DISPOFF)
+        cmd(ST7735_DISPOFF);
+    if (state >= ST7735_POWER_SLEEP)
+        sleep_in();
     unselect();
+    if (state == ST7735_POWER_VTFT_OFF)
+    {
+        /* The panel blanks within a frame after SLPIN, then the supply goes.
+         * The control lines go low so that they do not feed the panel
+         * through its protection diodes */
+        utils::delay_ms(ST7735_SLEEP_SETTLE_MS);
+        gpio_set_level(_vtft, 0);
+        gpio_set_level(_cs, 0);
+        gpio_set_level(_dc, 0);
+        gpio_set_level(_rst, 0);
+    }
     xSemaphoreGive(_mutex);
+    set_power(state);
     hold_pins();
-    ledc_set_duty(LEDC_MODE, LEDC_CH, 0);
-    ledc_update_duty(LEDC_MODE, LEDC_CH);
+}
+
+void HT_st7735::turn_off_for(uint32_t expected_ms)
+{
+    if (expected_ms >= ST7735_VTFT_OFF_MIN_OFF_MS)
+        turn_off(ST7735_POWER_VTFT_OFF);
+    else if (expected_ms >= ST7735_SLEEP_MIN_OFF_MS)
+        turn_off(ST7735_POWER_SLEEP);
+    else
+        turn_off(ST7735_POWER_DISPOFF);
+}
+
+void HT_st7735::sleep_in()
+{
+    /* The caller holds the mutex. SLPIN must come 120 ms after SLPOUT */
+    fence();
+    const int64_t since = esp_timer_get_time() - _sleep_ts;
+    if (since < ST7735_SLEEP_SETTLE_MS * 1000LL)
+        utils::delay_ms(ST7735_SLEEP_SETTLE_MS - since / 1000);
+    cmd(ST7735_SLPIN);
+    fence();
+    _sleep_ts = esp_timer_get_time();
+}
+
+void HT_st7735::power_up()
+{
+    /* The reset and the lists must not interleave with another transfer */
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    gpio_set_level(_rst, 1);
+    gpio_set_level(_vtft, 1);
+    utils::delay_ms(ST7735_VTFT_ON_MS);
+    select();
+    reset();
+    /* A minimal re-init: the reset left the controller in its defaults and
+     * asleep, there is no need for the software reset and the longer delays
+     * of init(). The address window is set again by the next drawing */
+    exec_cmd_list(sleep_out_cmds);
+    exec_cmd_list(config_cmds);
+    exec_cmd_list(gamma_cmds);
+    _colmod = ST7735_COLMOD_16;
+    _sleep_ts = esp_timer_get_time();
+    cmd(_inverted ? ST7735_INVON : ST7735_INVOFF);
+    if (_gamma)
+    {
+        cmd(ST7735_GAMSET);
+        data(&_gamma, 1);
+    }
+    if (_ptlar_valid)
+    {
+        cmd(ST7735_PTLAR);
+        data(_ptlar, sizeof(_ptlar));
+    }
+    if (_partial)
+        cmd(ST7735_PTLON);
+    if (_idle)
+        cmd(ST7735_IDMON);
+    unselect();
+    xSemaphoreGive(_mutex);
 }
 
 void HT_st7735::turn_on()
 {
+    if (_power < ST7735_POWER_DISPOFF)
+        return;
+    const st7735_power_t from = _power;
+    const int64_t start = esp_timer_get_time();
     unhold_pins();
+    if (from == ST7735_POWER_VTFT_OFF)
+    {
+        power_up();
+        /* The frame memory came back blank, every pixel has to go again */
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        _n_dirty = 0;
+        mark_dirty(0, 0, _width - 1, _height - 1);
+        xSemaphoreGive(_mutex);
+    }
+    set_power(_idle ? ST7735_POWER_DIM : ST7735_POWER_ON);
+    flush();
+
     xSemaphoreTake(_mutex, portMAX_DELAY);
     select();
+    if (from == ST7735_POWER_SLEEP)
+    {
+        /* SLPOUT must come 120 ms after SLPIN, and the booster needs as
+         * long again before the panel shows the frame memory */
+        fence();
+        const int64_t since = esp_timer_get_time() - _sleep_ts;
+        if (since < ST7735_SLEEP_SETTLE_MS * 1000LL)
+            utils::delay_ms(ST7735_SLEEP_SETTLE_MS - since / 1000);
+        cmd(ST7735_SLPOUT);
+        fence();
+        utils::delay_ms(ST7735_SLEEP_SETTLE_MS);
+        _sleep_ts = esp_timer_get_time();
+    }
     cmd(ST7735_DISPON);
     unselect();
     xSemaphoreGive(_mutex);
-    set_backlight(80);
+    /* Back to the level we had before turn_off() */
+    set_backlight(_backlight);
+
+    const int64_t latency = esp_timer_get_time() - start;
+    _power_stats.wakes[from]++;
+    _power_stats.wake_us[from] += latency;
+    _power_stats.max_wake_us[from] =
+        std::max(_power_stats.max_wake_us[from], latency);
+    ESP_LOGI(TAG, "Woke up from %s in %lld ms", power_names[from],
+             latency / 1000);
+}
+
+st7735_power_stats_t HT_st7735::get_power_stats() const
+{
+    st7735_power_stats_t stats = _power_stats;
+    stats.time_us[_power] += esp_timer_get_time() - _power_ts;
+    return stats;
+}
+
+void HT_st7735::set_idle_mode(bool enable)
+{
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _idle = enable;
+    if (_power < ST7735_POWER_DISPOFF)
+        set_power(enable ? ST7735_POWER_DIM : ST7735_POWER_ON);
+    select();
+    cmd(enable ? ST7735_IDMON : ST7735_IDMOFF);
+    unselect();
+    xSemaphoreGive(_mutex);
+}
+
+esp_err_t HT_st7735::set_partial_area(uint16_t x0, uint16_t x1)
+{
+    if (x0 > x1 || x1 >= _width)
+        return ESP_ERR_INVALID_ARG;
+
+    /* PTLAR addresses gate lines, which follow the logical x axis because of
+     * MV and are scanned in reverse when MY is set */
+    uint16_t start = x0 + _x_start;
+    uint16_t end = x1 + _x_start;
+    if (ST7735_ROTATION & ST7735_MADCTL_MY)
+    {
+        const uint16_t mirrored_start = ST7735_GATE_LINES - 1 - end;
+        end = ST7735_GATE_LINES - 1 - start;
+        start = mirrored_start;
+    }
+    uint8_t area[] = {(uint8_t)(start >> 8), (uint8_t)start,
+                      (uint8_t)(end >> 8), (uint8_t)end};
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    memcpy(_ptlar, area, sizeof(_ptlar));
+    _ptlar_valid = true;
+    select();
+    cmd(ST7735_PTLAR);
+    data(area, sizeof(area));
+    unselect();
+    xSemaphoreGive(_mutex);
+    return ESP_OK;
+}
+
+void HT_st7735::set_partial_mode(bool enable)
+{
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    _partial = enable;
+    select();
+    cmd(enable ? ST7735_PTLON : ST7735_NORON);
+    unselect();
+    xSemaphoreGive(_mutex);
+}
+
+esp_err_t HT_st7735::enable_framebuffer(bool enable)
+{
+    if (!enable)
+    {
+        /* Do not lose whatever was drawn but not pushed yet */
+        flush();
+        xSemaphoreTake(_mutex, portMAX_DELAY);
+        heap_caps_free(_fb);
+        _fb = nullptr;
+        _n_dirty = 0;
+        xSemaphoreGive(_mutex);
+        return ESP_OK;
+    }
+
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_fb)
+    {
+        _fb = static_cast<uint16_t*>(heap_caps_calloc(
+            _width * _height, sizeof(uint16_t), MALLOC_CAP_DMA));
+        if (!_fb)
+        {
+            ESP_LOGE(TAG, "Failed to allocate the framebuffer");
+            xSemaphoreGive(_mutex);
+            return ESP_ERR_NO_MEM;
+        }
+        /* We do not know what the panel shows, push everything once */
+        _n_dirty = 0;
+        mark_dirty(0, 0, _width - 1, _height - 1);
+        ESP_LOGI(TAG, "Framebuffer enabled (%d bytes)", _width * _height * 2);
+    }
+    xSemaphoreGive(_mutex);
+    return ESP_OK;
+}
+
+void HT_st7735::flush()
+{
+    /* Without a supply the regions wait for turn_on() */
+    if (!_fb || _power == ST7735_POWER_VTFT_OFF)
+        return;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_n_dirty)
+    {
+        xSemaphoreGive(_mutex);
+        return;
+    }
+    select();
+    for (size_t i = 0; i < _n_dirty; i++)
+    {
+        st7735_rect_t r = _dirty[i];
+        /* RGB444 cannot end on an odd pixel, take a column more of the
+         * framebuffer along. The screen width is even */
+        if (_format == ST7735_PIXEL_RGB444 &&
+            ((r.x1 - r.x0 + 1) * (r.y1 - r.y0 + 1)) & 1)
+        {
+            if (r.x1 + 1 < _width)
+                r.x1++;
+            else
+                r.x0--;
+        }
+        const uint16_t w = r.x1 - r.x0 + 1;
+        addr_window(r.x0, r.y0, r.x1, r.y1);
+        if (w == _width && _colmod == ST7735_COLMOD_16)
+        {
+            /* Full width regions are contiguous in the framebuffer */
+            data(reinterpret_cast<const uint8_t*>(&_fb[r.y0 * _width]),
+                 (r.y1 - r.y0 + 1) * _width * 2);
+            continue;
+        }
+        /* Gather the rows of narrower regions into as few strips as the
+         * line buffer allows */
+        uint16_t rows;
+        for (uint16_t y = r.y0; y <= r.y1; y += rows)
+        {
+            size_t capacity;
+            uint16_t* strip = next_strip(capacity);
+            rows = strip_rows(capacity, w, r.y1 - y + 1);
+            for (uint16_t j = 0; j < rows; j++)
+                memcpy(&strip[j * w], &_fb[(y + j) * _width + r.x0],
+                       w * sizeof(uint16_t));
+            send_strip(strip, rows * w);
+        }
+    }
+    _n_dirty = 0;
+    unselect();
+    xSemaphoreGive(_mutex);
+}
+
+esp_err_t HT_st7735::draw_bands(const st7735_rect_t* bands, size_t n,
+                                st7735_compose_fn compose, void* ctx,
+                                uint16_t cell)
+{
+    esp_err_t err = ESP_OK;
+    xSemaphoreTake(_mutex, portMAX_DELAY);
+    if (!_fb)
+        select();
+    for (size_t i = 0; i < n; i++)
+    {
+        const st7735_rect_t& b = bands[i];
+        const uint16_t w = b.x1 - b.x0 + 1;
+        const uint16_t h = b.y1 - b.y0 + 1;
+        /* Waits only for the band before the previous one */
+        size_t capacity;
+        uint16_t* strip = next_strip(capacity);
+        if (b.x0 > b.x1 || b.y0 > b.y1 || b.x1 >= _width ||
+            b.y1 >= _height || static_cast<size_t>(w) * h > capacity)
+        {
+            err = ESP_ERR_INVALID_SIZE;
+            continue;
+        }
+        compose(ctx, i, strip);
+        if (_fb)
+        {
+            fb_band(b.x0, b.y0, w, h, cell ? cell : w, strip);
+            continue;
+        }
+        addr_window(b.x0, b.y0, b.x1, b.y1);
+        send_strip(strip, w * h);
+    }
+    if (!_fb)
+        unselect();
+    xSemaphoreGive(_mutex);
+    if (err != ESP_OK)
+        ESP_LOGE(TAG, "Bands have to be on screen and fit in %u pixels",
+                 static_cast<unsigned>(_async ? ST7735_LINE_BUF_PIXELS / 2
+                                              : ST7735_LINE_BUF_PIXELS));
+    return err;
+}
+
+void HT_st7735::fb_fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                        uint16_t col)
+{
+    const uint16_t c = swap565(col);
+    uint16_t x0 = _width, y0 = _height, x1 = 0, y1 = 0;
+    for (uint16_t j = y; j < y + h; j++)
+    {
+        uint16_t* row = &_fb[j * _width];
+        for (uint16_t i = x; i < x + w; i++)
+        {
+            if (row[i] == c)
+                continue;
+            row[i] = c;
+            x0 = std::min(x0, i);
+            x1 = std::max(x1, i);
+            y0 = std::min(y0, j);
+            y1 = j;
+        }
+    }
+    if (x0 <= x1)
+        mark_dirty(x0, y0, x1, y1);
+}
+
+void HT_st7735::fb_char(uint16_t x, uint16_t y, char ch, const FontDef& f,
+                        uint16_t col, uint16_t bg)
+{
+    /* Expand the glyph once, then merge it into the framebuffer */
+    uint16_t glyph[ST7735_MAX_GLYPH_PIXELS];
+    f.blit(st7735_glyph(f, ch), 0, f.height, swap565(col), swap565(bg), glyph,
+           f.width);
+    uint16_t x0 = _width, y0 = _height, x1 = 0, y1 = 0;
+    for (uint16_t i = 0; i < f.height && y + i < _height; i++)
+    {
+        const uint16_t* src = &glyph[i * f.width];
+        uint16_t* row = &_fb[(y + i) * _width];
+        for (uint16_t j = 0; j < f.width && x + j < _width; j++)
+        {
+            uint16_t c = src[j];
+            if (row[x + j] == c)
+                continue;
+            row[x + j] = c;
+            x0 = std::min<uint16_t>(x0, x + j);
+            x1 = std::max<uint16_t>(x1, x + j);
+            y0 = std::min<uint16_t>(y0, y + i);
+            y1 = y + i;
+        }
+    }
+    if (x0 <= x1)
+        mark_dirty(x0, y0, x1, y1);
+}
+
+void HT_st7735::fb_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                         const uint16_t* img)
+{
+    /* Images are already stored in panel byte order */
+    uint16_t x0 = _width, y0 = _height, x1 = 0, y1 = 0;
+    for (uint16_t j = 0; j < h; j++)
+    {
+        uint16_t* row = &_fb[(y + j) * _width + x];
+        const uint16_t* src = &img[j * w];
+        for (uint16_t i = 0; i < w; i++)
+        {
+            if (row[i] == src[i])
+                continue;
+            row[i] = src[i];
+            x0 = std::min<uint16_t>(x0, x + i);
+            x1 = std::max<uint16_t>(x1, x + i);
+            y0 = std::min<uint16_t>(y0, y + j);
+            y1 = y + j;
+        }
+    }
+    if (x0 <= x1)
+        mark_dirty(x0, y0, x1, y1);
+}
+
+void HT_st7735::fb_band(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                        uint16_t cell, const uint16_t* band)
+{
+    /* Bands span cells that did not change, a region per cell keeps the
+     * flush to the pixels that did */
+    for (uint16_t c = 0; c < w; c += cell)
+    {
+        uint16_t x0 = _width, y0 = _height, x1 = 0, y1 = 0;
+        for (uint16_t j = 0; j < h; j++)
+        {
+            uint16_t* row = &_fb[(y + j) * _width + x];
+            const uint16_t* src = &band[j * w];
+            for (uint16_t i = c; i < std::min<uint16_t>(c + cell, w); i++)
+            {
+                if (row[i] == src[i])
+                    continue;
+                row[i] = src[i];
+                x0 = std::min<uint16_t>(x0, x + i);
+                x1 = std::max<uint16_t>(x1, x + i);
+                y0 = std::min<uint16_t>(y0, y + j);
+                y1 = y + j;
+            }
+        }
+        if (x0 <= x1)
+            mark_dirty(x0, y0, x1, y1);
+    }
+}
+
+void HT_st7735::mark_dirty(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1)
+{
+    st7735_rect_t r = {x0, y0, x1, y1};
+    bool merged;
+    do
+    {
+        merged = false;
+        /* Absorb any pending region that overlaps or touches the new one */
+        for (size_t i = 0; i < _n_dirty; i++)
+        {
+            const st7735_rect_t& d = _dirty[i];
+            if (d.x0 > r.x1 + 1 || r.x0 > d.x1 + 1 || d.y0 > r.y1 + 1 ||
+                r.y0 > d.y1 + 1)
+                continue;
+            r = {std::min(r.x0, d.x0), std::min(r.y0, d.y0),
+                 std::max(r.x1, d.x1), std::max(r.y1, d.y1)};
+            _dirty[i] = _dirty[--_n_dirty];
+            merged = true;
+            break;
+        }
+        if (merged || _n_dirty < ST7735_MAX_DIRTY_RECTS)
+            continue;
+
+        /* Out of slots, fold into the region whose bounding box grows least */
+        size_t best = 0;
+        uint32_t best_growth = UINT32_MAX;
+        for (size_t i = 0; i < _n_dirty; i++)
+        {
+            const st7735_rect_t& d = _dirty[i];
+            uint32_t w = std::max(r.x1, d.x1) - std::min(r.x0, d.x0) + 1;
+            uint32_t h = std::max(r.y1, d.y1) - std::min(r.y0, d.y0) + 1;
+            uint32_t growth = w * h - (d.x1 - d.x0 + 1) * (d.y1 - d.y0 + 1);
+            if (growth < best_growth)
+            {
+                best_growth = growth;
+                best = i;
+            }
+        }
+        const st7735_rect_t& d = _dirty[best];
+        r = {std::min(r.x0, d.x0), std::min(r.y0, d.y0), std::max(r.x1, d.x1),
+             std::max(r.y1, d.y1)};
+        _dirty[best] = _dirty[--_n_dirty];
+        merged = true;
+    } while (merged);
+    _dirty[_n_dirty++] = r;
 }
@@ -12,9 +12,12 @@
  */
 
 #include "HT_st7735_fonts.hpp"
+#include "HT_st7735_image.hpp"
+#include "HT_st7735_sprite.hpp"
 #include "driver/gpio.h"
 #include "driver/ledc.h"
 #include "driver/spi_master.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
@@ -44,6 +47,9 @@ constexpr uint8_t ST7735_MADCTL_MV = 0x20;
 constexpr uint8_t ST7735_MADCTL_BGR = 0x08;
 constexpr uint8_t ST7735_ROTATION =
     (ST7735_MADCTL_MY | ST7735_MADCTL_MV | ST7735_MADCTL_BGR);
+/* Gate lines of the controller frame memory. With MV set they run along the
+ * logical x axis, so partial areas are vertical bands of columns */
+constexpr uint16_t ST7735_GATE_LINES = 162;
 
 /* ------------------- Color definitions ---------------------------------- */
 #define ST7735_BLACK 0x0000
@@ -68,9 +74,99 @@ typedef enum
 
 #define DELAY 0x80
 
+/* -------------------------- SPI transfers --------------------------------- */
+constexpr int ST7735_QUEUE_SIZE = 7;
+
+/* Passed as the transaction user data, consumed by the pre-transfer callback */
+typedef struct
+{
+    gpio_num_t pin;
+    uint32_t level;
+} st7735_dc_t;
+
+typedef struct
+{
+    int64_t blocked_us;    /* Time spent sleeping on SPI completions */
+    uint32_t commands;     /* Command bytes sent */
+    uint32_t transactions; /* SPI transactions, commands included */
+    uint32_t bytes;        /* Bytes clocked out, commands included */
+    uint32_t skipped;      /* CASET/RASET left out, the panel had them */
+} st7735_stats_t;
+
+/* -------------------------- Pixel formats --------------------------------- */
+typedef enum
+{
+    ST7735_PIXEL_RGB565, /* 2 bytes per pixel */
+    ST7735_PIXEL_RGB444, /* 3 bytes per 2 pixels, the lowest bits are lost */
+} st7735_pixel_format_t;
+
+/* -------------------------- Power states ---------------------------------- */
+typedef enum
+{
+    ST7735_POWER_ON,       /* Displaying */
+    ST7735_POWER_DIM,      /* Displaying in the 8-colour idle mode */
+    ST7735_POWER_DISPOFF,  /* Blank, the controller still scans the panel */
+    ST7735_POWER_SLEEP,    /* Sleep in, booster and oscillator stopped */
+    ST7735_POWER_VTFT_OFF, /* Unpowered, the frame memory is lost */
+    ST7735_POWER_STATES
+} st7735_power_t;
+
+/* Off durations from which turn_off_for() goes to sleep, or cuts VTFT. Each
+ * state is deeper but slower to wake up from */
+#ifndef ST7735_SLEEP_MIN_OFF_MS
+#define ST7735_SLEEP_MIN_OFF_MS 2000
+#endif
+#ifndef ST7735_VTFT_OFF_MIN_OFF_MS
+#define ST7735_VTFT_OFF_MIN_OFF_MS 60000
+#endif
+
+/* Datasheet timings. SLPIN and SLPOUT have to be 120 ms apart, and the
+ * supply settles within VTFT_ON before the panel is reset */
+constexpr uint32_t ST7735_SLEEP_SETTLE_MS = 120;
+constexpr uint32_t ST7735_VTFT_ON_MS = 10;
+
+typedef struct
+{
+    int64_t time_us[ST7735_POWER_STATES];     /* Time spent in each state */
+    uint32_t wakes[ST7735_POWER_STATES];      /* turn_on() from each state */
+    int64_t wake_us[ST7735_POWER_STATES];     /* Total latency of the wakes */
+    int64_t max_wake_us[ST7735_POWER_STATES]; /* Slowest wake */
+} st7735_power_stats_t;
+
+/* -------------------------- Line buffer ----------------------------------- */
+/* Enough for a full-width row of the tallest font (Font_16x26) in one go.
+ * Queued transfers split it into two ping-pong strips, any taller drawing is
+ * sent a strip at a time. 20 rows still hold two bands of Font_7x10 text */
+#ifndef ST7735_LINE_BUF_ROWS
+#define ST7735_LINE_BUF_ROWS 26
+#endif
+constexpr size_t ST7735_LINE_BUF_PIXELS = ST7735_WIDTH * ST7735_LINE_BUF_ROWS;
+
+/* Longest run of glyphs expanded at once, covers a row of the narrowest font */
+constexpr size_t ST7735_MAX_GLYPH_RUN = 24;
+/* Pixels of the largest glyph (Font_16x26) */
+constexpr size_t ST7735_MAX_GLYPH_PIXELS = 16 * 26;
+
+/* -------------------------- Shadow framebuffer ---------------------------- */
+constexpr size_t ST7735_MAX_DIRTY_RECTS = 8;
+
+typedef struct
+{
+    uint16_t x0, y0; /* Top left corner (inclusive) */
+    uint16_t x1, y1; /* Bottom right corner (inclusive) */
+} st7735_rect_t;
+
+/* -------------------------- Band composition ------------------------------ */
+/* Compose band number band of a draw_bands() call into pixels, in panel byte
+ * order (see HT_st7735::swap565) and with the width of the band as stride */
+typedef void (*st7735_compose_fn)(void* ctx, size_t band, uint16_t* pixels);
+
 /* ---------------- Initialisation Command Sequences ------------------------ */
 extern const uint8_t init_cmds1[]; // paste as‑is or place in another .c file
+extern const uint8_t config_cmds[];
+extern const uint8_t sleep_out_cmds[];
 extern const uint8_t init_cmds2[];
+extern const uint8_t gamma_cmds[];
 extern const uint8_t init_cmds3[];
 
 /* ---------------------------------  Driver ---------------------------------
@@ -104,24 +200,219 @@ public:
     }
     void draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
                     const uint16_t* d);
+
+    /**
+     * @brief Draw a palette plus run-length compressed image. Like sprites,
+     * it is expanded strip by strip, there is no full size copy.
+     *
+     * @param x
+     * @param y
+     * @param image
+     */
+    void draw_image(uint16_t x, uint16_t y, const st7735_image_t& image);
+
+    /**
+     * @brief Draw a run-length compressed sprite. The runs are expanded
+     * straight into the transfer strips, there is no full size copy.
+     *
+     * @param x
+     * @param y
+     * @param sprite
+     * @param color the foreground
+     * @param bgcolor the background
+     */
+    void draw_sprite(uint16_t x, uint16_t y, const st7735_sprite_t& sprite,
+                     uint16_t color, uint16_t bgcolor);
     void invert_colors(bool inv);
     void set_gamma(uint8_t gamma);
     void hold_pins(void);
     void unhold_pins(void);
-    void set_backlight(const uint8_t percent);
+
+    /**
+     * @brief Set the backlight, at once or with a hardware fade. A fade runs
+     * on the LEDC and the call returns straight away.
+     *
+     * @param percent
+     * @param fade_ms length of the fade, 0 to set the level at once
+     */
+    void set_backlight(uint8_t percent, uint32_t fade_ms = 0);
+    /** @brief The last level set, the target of a fade in progress */
+    uint8_t get_backlight() const { return _backlight; }
     void hold_backlight(bool enable = true);
-    void turn_off();
+
+    /**
+     * @brief Switch the panel off, with the backlight. Deeper states draw
+     * less current but take longer to wake up from: DISPOFF only blanks
+     * the panel, SLEEP stops the booster and the oscillator and VTFT_OFF
+     * cuts the panel supply. The frame memory survives all but VTFT_OFF,
+     * which needs the framebuffer to repaint from, without it the panel
+     * only goes to sleep. A deeper off state than the current one is
+     * entered from there, a lighter one is ignored.
+     *
+     * @param state one of the off states
+     */
+    void turn_off(st7735_power_t state = ST7735_POWER_DISPOFF);
+
+    /**
+     * @brief turn_off() into the deepest state worth its wake-up for an off
+     * period of the given length, see ST7735_SLEEP_MIN_OFF_MS and
+     * ST7735_VTFT_OFF_MIN_OFF_MS.
+     *
+     * @param expected_ms how long the panel is expected to stay off
+     */
+    void turn_off_for(uint32_t expected_ms);
+
+    /**
+     * @brief Wake the panel up from any off state, keeping to the datasheet
+     * delays. After VTFT_OFF the registers are restored with a minimal
+     * re-init and the frame memory is repainted from the framebuffer before
+     * the panel is switched on.
+     */
     void turn_on();
 
+    st7735_power_t get_power_state() const { return _power; }
+
+    /** @brief Time spent in and wake-up latency from each state since boot */
+    st7735_power_stats_t get_power_stats() const;
+
+    /**
+     * @brief Enter or leave the 8-colour idle mode (IDMON/IDMOFF). Only the
+     * MSB of each colour channel is displayed, which lowers the panel current.
+     *
+     * @param enable
+     */
+    void set_idle_mode(bool enable = true);
+
+    /**
+     * @brief Set the partial display area to the logical columns [x0, x1]
+     * (PTLAR). The area is used once set_partial_mode() is enabled.
+     *
+     * @param x0
+     * @param x1
+     * @return esp_err_t ESP_ERR_INVALID_ARG if the range is empty or off screen
+     */
+    esp_err_t set_partial_area(uint16_t x0, uint16_t x1);
+
+    /**
+     * @brief Switch between partial (PTLON) and normal (NORON) display mode.
+     * In partial mode only the partial area is driven, the rest of the panel
+     * is blank.
+     *
+     * @param enable
+     */
+    void set_partial_mode(bool enable = true);
+
+    /**
+     * @brief Enable or disable the RGB565 shadow framebuffer. While enabled,
+     * the drawing calls only update RAM and record the regions that actually
+     * changed, the panel is updated on flush().
+     *
+     * @param enable
+     * @return esp_err_t ESP_ERR_NO_MEM if the framebuffer cannot be allocated
+     */
+    esp_err_t enable_framebuffer(bool enable = true);
+
+    /**
+     * @brief Push the dirty regions of the shadow framebuffer to the panel.
+     * No-op when the framebuffer is disabled.
+     *
+     */
+    void flush();
+
+    /**
+     * @brief Draw screen bands composed by the caller straight into the
+     * ping-pong strips of the line buffer. Band n + 1 is composed while band
+     * n is still being clocked out, and every pixel is sent once, so the
+     * bands need neither a framebuffer nor any copy of them. With the
+     * framebuffer enabled, the bands are merged into it instead.
+     *
+     * @param bands the areas, each has to fit in half of the line buffer
+     * @param n
+     * @param compose called once per band, in order
+     * @param ctx passed to compose
+     * @param cell width of the cells the bands are made of, the framebuffer
+     * tracks the changes of each cell on its own. 0 for the whole band
+     * @return esp_err_t ESP_ERR_INVALID_SIZE if a band was off screen or too
+     * big, the other bands are drawn
+     */
+    esp_err_t draw_bands(const st7735_rect_t* bands, size_t n,
+                         st7735_compose_fn compose, void* ctx,
+                         uint16_t cell = 0);
+
+    /** @brief An RGB565 colour in panel byte order, as the strips hold it */
+    static inline uint16_t swap565(uint16_t c)
+    {
+        return static_cast<uint16_t>((c >> 8) | (c << 8));
+    }
+
+    /**
+     * @brief Choose the format the pixels are sent in. RGB444 moves a
+     * quarter fewer bytes, which flat UI colours hardly notice. The
+     * pixels are still drawn in RGB565 and packed on their way out. Areas
+     * of an odd number of pixels, which RGB444 cannot end, keep going out
+     * in RGB565.
+     *
+     * @param format
+     */
+    void set_pixel_format(st7735_pixel_format_t format);
+    st7735_pixel_format_t get_pixel_format() const { return _format; }
+
+    /**
+     * @brief Choose between queued DMA transfers, where the calling task
+     * sleeps while the panel is fed, and polling transfers, where the CPU
+     * spins for the whole transfer. Queued transfers are the default.
+     *
+     * @param enable
+     */
+    void set_async(bool enable = true);
+
+    /** @brief Transfer statistics since the last reset_stats() */
+    st7735_stats_t get_stats() const { return _stats; }
+    void reset_stats() { _stats = {}; }
+
 private:
     /* SPI helpers */
     inline void select() { gpio_set_level(_cs, 0); }
-    inline void unselect() { gpio_set_level(_cs, 1); }
+    inline void unselect()
+    {
+        /* CS is driven manually, it must stay low until the queue drains */
+        fence();
+        gpio_set_level(_cs, 1);
+    }
     void reset();
+    void power_up();
+    void sleep_in();
+    void set_power(st7735_power_t state);
     inline void cmd(uint8_t c);
     inline void data(const uint8_t* d, size_t len);
+    void transfer(const uint8_t* d, size_t len, const st7735_dc_t* dc);
+    void reap();
+    void fence();
+    uint16_t* next_strip(size_t& capacity);
+    uint16_t strip_rows(size_t capacity, uint16_t w, uint16_t left) const;
+    void send_strip(uint16_t* strip, size_t pixels);
+    bool packs(uint32_t pixels) const
+    {
+        return _format == ST7735_PIXEL_RGB444 && !(pixels & 1);
+    }
+    template <typename Source>
+    void draw_strips(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                     Source& src);
     void exec_cmd_list(const uint8_t* addr);
     void addr_window(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+    void write_glyphs(uint16_t x, uint16_t y, const char* s, size_t n,
+                      const FontDef& font, uint16_t color, uint16_t bgcolor);
+
+    /* Shadow framebuffer helpers, the pixels are kept in panel byte order */
+    void fb_fill(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                 uint16_t color);
+    void fb_char(uint16_t x, uint16_t y, char ch, const FontDef& font,
+                 uint16_t color, uint16_t bgcolor);
+    void fb_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                  const uint16_t* img);
+    void fb_band(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                 uint16_t cell, const uint16_t* band);
+    void mark_dirty(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1);
 
     gpio_num_t _cs, _rst, _dc, _sclk, _mosi, _led, _vtft;
     spi_device_handle_t _spi;
@@ -131,5 +422,37 @@ private:
     static constexpr ledc_channel_t LEDC_CH = LEDC_CHANNEL_0;
     static constexpr uint32_t LEDC_FREQ_HZ = 1000;
     static constexpr uint32_t LEDC_RES_BITS = 10;
+    uint8_t _backlight = 100; /* %, kept across turn_off() */
+    st7735_power_t _power = ST7735_POWER_ON;
+    int64_t _power_ts = 0; /* When _power was entered */
+    int64_t _sleep_ts = 0; /* Last SLPIN or SLPOUT */
+    st7735_power_stats_t _power_stats = {};
+    /* Settings that VTFT_OFF loses, restored by power_up() */
+    bool _inverted = false;
+    bool _idle = false;
+    bool _partial = false;
+    uint8_t _gamma = 0; /* 0 while set_gamma() was not called */
+    uint8_t _ptlar[4] = {};
+    bool _ptlar_valid = false;
     SemaphoreHandle_t _mutex = nullptr;
+    st7735_dc_t _dc_cmd, _dc_data; /* DC levels for commands and data */
+    bool _async = true;            /* Queued DMA or polling transfers */
+    st7735_pixel_format_t _format = ST7735_PIXEL_RGB565;
+    uint8_t _colmod = 0; /* COLMOD the panel holds */
+    spi_transaction_t _trans[ST7735_QUEUE_SIZE]; /* Queued descriptors */
+    size_t _next_trans = 0;
+    size_t _in_flight = 0;
+    uint32_t _seq_queued = 0; /* Sequence number of the last queued transfer */
+    uint32_t _seq_done = 0;   /* Sequence number of the last completed one */
+    uint32_t _strip_seq[2] = {0, 0}; /* Last transfer using each strip */
+    uint8_t _strip = 0;
+    st7735_stats_t _stats = {};
+    uint16_t* _line_buf = nullptr; /* DMA scratch, ST7735_LINE_BUF_PIXELS */
+    uint16_t* _fb = nullptr; /* Shadow framebuffer or nullptr if disabled */
+    st7735_rect_t _dirty[ST7735_MAX_DIRTY_RECTS]; /* Pending regions */
+    size_t _n_dirty = 0;
+    st7735_rect_t _window = {};  /* Address window the panel holds */
+    bool _window_valid = false; /* False until set, or after a reset */
 };
+
+void st7735_benchmark_task(void* args);
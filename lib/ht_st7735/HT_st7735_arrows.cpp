@@ -0,0 +1,100 @@
+/**
+ * @file HT_st7735_arrows.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Direction arrow sprite atlas, generated by scripts/arrow_atlas.py.
+ * Do not edit, run the script instead.
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "HT_st7735_sprite.hpp"
+
+static const uint8_t arrow_0[] = {
+    0xf0, 0x52, 0xb4, 0x96, 0x78, 0x92, 0xc2, 0xc2, 0xc2, 0xc2, 0x60,
+};
+
+static const uint8_t arrow_1[] = {
+    0xf0, 0x62, 0xa5, 0x86, 0xa4, 0xa2, 0x12, 0x83, 0xb2, 0xb3, 0xc1, 0x80,
+};
+
+static const uint8_t arrow_2[] = {
+    0xf0, 0x81, 0x96, 0x94, 0xa4, 0x95, 0x83, 0x21, 0x73, 0xb2, 0xf0, 0x80,
+};
+
+static const uint8_t arrow_3[] = {
+    0xf0, 0x51, 0xd4, 0xb4, 0x86, 0x67, 0x64, 0x22, 0x71, 0x41, 0xf0, 0xf0,
+    0x30,
+};
+
+static const uint8_t arrow_4[] = {
+    0xf0, 0x61, 0xd2, 0xc3, 0x69, 0x59, 0xa3, 0xb2, 0xc1, 0xf0, 0x50,
+};
+
+static const uint8_t arrow_5[] = {
+    0xf0, 0xf0, 0x11, 0x41, 0x74, 0x22, 0x77, 0x96, 0xa4, 0x94, 0xa1, 0xf0,
+    0x60,
+};
+
+static const uint8_t arrow_6[] = {
+    0xf0, 0x22, 0xc3, 0xc3, 0x21, 0x95, 0xa4, 0xa4, 0x96, 0xc1, 0xf0, 0x30,
+};
+
+static const uint8_t arrow_7[] = {
+    0x51, 0xc3, 0xc2, 0xc3, 0xc2, 0x12, 0x94, 0x86, 0x95, 0xb2, 0xf0, 0x40,
+};
+
+static const uint8_t arrow_8[] = {
+    0x62, 0xc2, 0xc2, 0xc2, 0xc2, 0x98, 0x76, 0x94, 0xb2, 0xf0, 0x50,
+};
+
+static const uint8_t arrow_9[] = {
+    0x81, 0xc3, 0xb2, 0xb3, 0x82, 0x12, 0xa4, 0xa6, 0x85, 0xa2, 0xf0, 0x60,
+};
+
+static const uint8_t arrow_10[] = {
+    0xf0, 0x82, 0xb3, 0x71, 0x23, 0x85, 0x94, 0xa4, 0x96, 0x91, 0xf0, 0x80,
+};
+
+static const uint8_t arrow_11[] = {
+    0xf0, 0xf0, 0x31, 0x41, 0x72, 0x24, 0x67, 0x66, 0x84, 0xb4, 0xd1, 0xf0,
+    0x50,
+};
+
+static const uint8_t arrow_12[] = {
+    0xf0, 0x51, 0xc2, 0xb3, 0xa9, 0x59, 0x63, 0xc2, 0xd1, 0xf0, 0x60,
+};
+
+static const uint8_t arrow_13[] = {
+    0xf0, 0x61, 0xa4, 0x94, 0xa6, 0x97, 0x72, 0x24, 0x71, 0x41, 0xf0, 0xf0,
+    0x10,
+};
+
+static const uint8_t arrow_14[] = {
+    0xf0, 0x31, 0xc6, 0x94, 0xa4, 0xa5, 0x91, 0x23, 0xc3, 0xc2, 0xf0, 0x20,
+};
+
+static const uint8_t arrow_15[] = {
+    0xf0, 0x42, 0xb5, 0x96, 0x84, 0x92, 0x12, 0xc3, 0xc2, 0xc3, 0xc1, 0x50,
+};
+
+const st7735_sprite_t st7735_arrows[ST7735_ARROW_COUNT] = {
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_0, sizeof(arrow_0)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_1, sizeof(arrow_1)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_2, sizeof(arrow_2)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_3, sizeof(arrow_3)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_4, sizeof(arrow_4)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_5, sizeof(arrow_5)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_6, sizeof(arrow_6)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_7, sizeof(arrow_7)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_8, sizeof(arrow_8)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_9, sizeof(arrow_9)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_10, sizeof(arrow_10)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_11, sizeof(arrow_11)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_12, sizeof(arrow_12)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_13, sizeof(arrow_13)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_14, sizeof(arrow_14)},
+    {ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_15, sizeof(arrow_15)},
+};
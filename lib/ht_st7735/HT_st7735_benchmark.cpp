@@ -0,0 +1,160 @@
+/**
+ * @file HT_st7735_benchmark.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Compares the CPU time spent by the polling and the queued DMA
+ * transfer paths of the ST7735 driver and the SPI time of its pixel formats,
+ * and times the glyph blitters
+ * @version 0.1
+ * @date 2025-07-20
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "HT_st7735.hpp"
+#include "esp_log.h"
+#include "esp_pm.h"
+#include "esp_timer.h"
+#include <utils.hpp>
+
+static const char* TAG = "st7735_bench";
+
+constexpr int ST7735_BENCHMARK_FRAMES = 20;
+constexpr size_t ST7735_BENCHMARK_SLEEP = 5000;
+constexpr int ST7735_BENCHMARK_GLYPHS = 950; /* 10 passes over the charset */
+constexpr size_t ST7735_FONT_CHARSET = '~' - ' ' + 1;
+constexpr int ST7735_BENCHMARK_UPDATES = 20;
+
+typedef struct
+{
+    int64_t us;     /* Per update */
+    uint32_t bytes; /* Per update */
+} st7735_benchmark_cost_t;
+
+/* Roughly what a full refresh of the main screen costs */
+static void st7735_benchmark_frame(HT_st7735* display)
+{
+    display->fill_screen(ST7735_BLACK);
+    for (int row = 0; row < ST7735_HEIGHT / Font_7x10.height; row++)
+        display->write_str(0, row * Font_7x10.height, "Alice 1234m go FR (45)",
+                           Font_7x10, ST7735_CYAN, ST7735_BLACK);
+    display->write_str(0, 0, "Astrolavos", Font_11x18, ST7735_GREEN,
+                       ST7735_BLACK);
+}
+
+static void st7735_benchmark_run(HT_st7735* display, bool async)
+{
+    display->set_async(async);
+    display->reset_stats();
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < ST7735_BENCHMARK_FRAMES; i++)
+        st7735_benchmark_frame(display);
+    int64_t wall = (esp_timer_get_time() - start) / ST7735_BENCHMARK_FRAMES;
+    st7735_stats_t spi = display->get_stats();
+    int64_t blocked = spi.blocked_us / ST7735_BENCHMARK_FRAMES;
+
+    /* Time blocked on completions is time the CPU was free to sleep */
+    ESP_LOGI(TAG, "%s: %lld us/frame, CPU busy %lld us/frame, blocked %lld us",
+             async ? "queued" : "polling", wall, wall - blocked, blocked);
+    ESP_LOGI(TAG, "per frame: %lu commands, %lu transactions, %lu bytes, "
+             "%lu CASET/RASET skipped", spi.commands / ST7735_BENCHMARK_FRAMES,
+             spi.transactions / ST7735_BENCHMARK_FRAMES,
+             spi.bytes / ST7735_BENCHMARK_FRAMES,
+             spi.skipped / ST7735_BENCHMARK_FRAMES);
+}
+
+/* Full-screen fills, then rewrites of a full row of Font_7x10 text */
+static void st7735_benchmark_updates(HT_st7735* display,
+                                     st7735_benchmark_cost_t& screen,
+                                     st7735_benchmark_cost_t& row)
+{
+    display->reset_stats();
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < ST7735_BENCHMARK_UPDATES; i++)
+        display->fill_screen((i & 1) ? ST7735_BLUE : ST7735_BLACK);
+    screen.us = (esp_timer_get_time() - start) / ST7735_BENCHMARK_UPDATES;
+    screen.bytes = display->get_stats().bytes / ST7735_BENCHMARK_UPDATES;
+
+    display->reset_stats();
+    start = esp_timer_get_time();
+    for (int i = 0; i < ST7735_BENCHMARK_UPDATES; i++)
+        display->write_str(0, 0, (i & 1) ? "Alice 1234m go FR (45)"
+                                         : "Bob    987m go NW (12)",
+                           Font_7x10, ST7735_CYAN, ST7735_BLACK);
+    row.us = (esp_timer_get_time() - start) / ST7735_BENCHMARK_UPDATES;
+    row.bytes = display->get_stats().bytes / ST7735_BENCHMARK_UPDATES;
+}
+
+static void st7735_benchmark_formats(HT_st7735* display)
+{
+    st7735_benchmark_cost_t screen565, row565, screen444, row444;
+    display->set_pixel_format(ST7735_PIXEL_RGB565);
+    st7735_benchmark_updates(display, screen565, row565);
+    display->set_pixel_format(ST7735_PIXEL_RGB444);
+    st7735_benchmark_updates(display, screen444, row444);
+    display->set_pixel_format(ST7735_PIXEL_RGB565);
+
+    ESP_LOGI(TAG, "full screen: RGB565 %lu bytes %lld us, RGB444 %lu bytes "
+             "%lld us, %lld us saved", screen565.bytes, screen565.us,
+             screen444.bytes, screen444.us, screen565.us - screen444.us);
+    ESP_LOGI(TAG, "text row: RGB565 %lu bytes %lld us, RGB444 %lu bytes "
+             "%lld us, %lld us saved", row565.bytes, row565.us, row444.bytes,
+             row444.us, row565.us - row444.us);
+}
+
+/* A per-pixel loop with the sizes read at run time, the shape of the
+ * expansion before the blitters were specialised */
+static void st7735_benchmark_generic_blit(const FontDef& f, char ch,
+                                          uint16_t* dst)
+{
+    const uint8_t* glyph = st7735_glyph(f, ch);
+    for (uint32_t bit = 0; bit < (uint32_t)f.width * f.height; bit++)
+        dst[bit] = (glyph[bit / 8] & (0x80 >> (bit % 8))) ? 0xFFFF : 0;
+}
+
+static void st7735_benchmark_font(const char* name, const FontDef& f)
+{
+    static uint16_t pixels[ST7735_MAX_GLYPH_PIXELS];
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < ST7735_BENCHMARK_GLYPHS; i++)
+        st7735_benchmark_generic_blit(f, ' ' + i % ST7735_FONT_CHARSET,
+                                      pixels);
+    int64_t generic = esp_timer_get_time() - start;
+    start = esp_timer_get_time();
+    for (int i = 0; i < ST7735_BENCHMARK_GLYPHS; i++)
+        f.blit(st7735_glyph(f, ' ' + i % ST7735_FONT_CHARSET), 0, f.height,
+               0xFFFF, 0, pixels, f.width);
+    int64_t specialised = esp_timer_get_time() - start;
+
+    ESP_LOGI(TAG, "%s: %u bytes packed (%u as rows), %lld ns/glyph generic, "
+             "%lld ns/glyph specialised", name,
+             f.glyph_bytes * ST7735_FONT_CHARSET,
+             f.height * sizeof(uint16_t) * ST7735_FONT_CHARSET,
+             generic * 1000 / ST7735_BENCHMARK_GLYPHS,
+             specialised * 1000 / ST7735_BENCHMARK_GLYPHS);
+}
+
+void st7735_benchmark_task(void* args)
+{
+    esp_pm_lock_handle_t lock;
+    esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "st7735_bench_lock", &lock);
+    HT_st7735* display = static_cast<HT_st7735*>(args);
+    ESP_LOGI(TAG, "ST7735 Benchmark Task started");
+
+    /* Measure the transfers themselves, not the shadow framebuffer */
+    display->enable_framebuffer(false);
+    while (true)
+    {
+        esp_pm_lock_acquire(lock);
+        display->unhold_pins();
+        st7735_benchmark_run(display, false);
+        st7735_benchmark_run(display, true);
+        st7735_benchmark_formats(display);
+        display->hold_pins();
+        st7735_benchmark_font("Font_7x10", Font_7x10);
+        st7735_benchmark_font("Font_11x18", Font_11x18);
+        st7735_benchmark_font("Font_16x26", Font_16x26);
+        esp_pm_lock_release(lock);
+        utils::delay_ms(ST7735_BENCHMARK_SLEEP);
+    }
+}
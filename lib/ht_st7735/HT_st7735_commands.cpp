@@ -13,25 +13,29 @@
 #include "HT_st7735.hpp"
 
 const uint8_t init_cmds1[] = { // Init for 7735R, part 1 (red or green tab)
-    15,                        // 15 commands in list:
+    2,                         //  2 commands in list:
     ST7735_SWRESET,
     DELAY, //  1: Software reset, 0 args, w/delay
     150,   //     150 ms delay
     ST7735_SLPOUT,
     DELAY, //  2: Out of sleep mode, 0 args, w/delay
-    255,   //     500 ms delay
+    255};  //     500 ms delay
+
+/* Registers lost with VTFT, sent by the init and again by the restore */
+const uint8_t config_cmds[] = {
+    13, // 13 commands in list:
     ST7735_FRMCTR1,
-    3, //  3: Frame rate ctrl - normal mode, 3 args:
+    3, //  1: Frame rate ctrl - normal mode, 3 args:
     0x01,
     0x2C,
     0x2D, //     Rate = fosc/(1x2+40) * (LINE+2C+2D)
     ST7735_FRMCTR2,
-    3, //  4: Frame rate control - idle mode, 3 args:
+    3, //  2: Frame rate control - idle mode, 3 args:
     0x01,
     0x2C,
     0x2D, //     Rate = fosc/(1x2+40) * (LINE+2C+2D)
     ST7735_FRMCTR3,
-    6, //  5: Frame rate ctrl - partial mode, 6 args:
+    6, //  3: Frame rate ctrl - partial mode, 6 args:
     0x01,
     0x2C,
     0x2D, //     Dot inversion mode
@@ -39,40 +43,44 @@ const uint8_t init_cmds1[] = { // Init for 7735R, part 1 (red or green tab)
     0x2C,
     0x2D, //     Line inversion mode
     ST7735_INVCTR,
-    1,    //  6: Display inversion ctrl, 1 arg, no delay:
+    1,    //  4: Display inversion ctrl, 1 arg, no delay:
     0x07, //     No inversion
     ST7735_PWCTR1,
-    3, //  7: Power control, 3 args, no delay:
+    3, //  5: Power control, 3 args, no delay:
     0xA2,
     0x02, //     -4.6V
     0x84, //     AUTO mode
     ST7735_PWCTR2,
-    1,    //  8: Power control, 1 arg, no delay:
+    1,    //  6: Power control, 1 arg, no delay:
     0xC5, //     VGH25 = 2.4C VGSEL = -10 VGH = 3 * AVDD
     ST7735_PWCTR3,
-    2,    //  9: Power control, 2 args, no delay:
+    2,    //  7: Power control, 2 args, no delay:
     0x0A, //     Opamp current small
     0x00, //     Boost frequency
     ST7735_PWCTR4,
-    2,    // 10: Power control, 2 args, no delay:
+    2,    //  8: Power control, 2 args, no delay:
     0x8A, //     BCLK/2, Opamp current small & Medium low
     0x2A,
     ST7735_PWCTR5,
-    2, // 11: Power control, 2 args, no delay:
+    2, //  9: Power control, 2 args, no delay:
     0x8A,
     0xEE,
     ST7735_VMCTR1,
-    1, // 12: Power control, 1 arg, no delay:
+    1, // 10: Power control, 1 arg, no delay:
     0x0E,
     ST7735_INVOFF,
-    0, // 13: Don't invert display, no args, no delay
+    0, // 11: Don't invert display, no args, no delay
     ST7735_MADCTL,
-    1,               // 14: Memory access control (directions), 1 arg:
+    1,               // 12: Memory access control (directions), 1 arg:
     ST7735_ROTATION, //     row addr/col addr, bottom to top refresh
     ST7735_COLMOD,
-    1,     // 15: set color mode, 1 arg, no delay:
+    1,     // 13: set color mode, 1 arg, no delay:
     0x05}; //     16-bit color
 
+/* Out of sleep after a reset, the supply and the booster settle in 120 ms */
+const uint8_t sleep_out_cmds[] = {1, ST7735_SLPOUT, DELAY,
+                                  ST7735_SLEEP_SETTLE_MS};
+
 #if (defined(ST7735_IS_128X128) || defined(ST7735_IS_160X128))
 const uint8_t init_cmds2[] = { // Init for 7735R, part 2 (1.44" display)
     2,                         //  2 commands in list:
@@ -108,9 +116,9 @@ const uint8_t init_cmds2[] = { // Init for 7735S, part 2 (160x80 display)
     0}; //  3: Invert colors
 #endif
 
-const uint8_t init_cmds3[] = {
+const uint8_t gamma_cmds[] = {
     // Init for 7735R, part 3 (red or green tab)
-    4, //  4 commands in list:
+    2, //  2 commands in list:
     ST7735_GMCTRP1,
     16, //  1: Gamma Adjustments (pos. polarity), 16 args, no delay:
     0x02,
@@ -146,11 +154,14 @@ const uint8_t init_cmds3[] = {
     0x00,
     0x00,
     0x02,
-    0x10,
+    0x10};
+
+const uint8_t init_cmds3[] = {
+    2, //  2 commands in list:
     ST7735_NORON,
-    DELAY, //  3: Normal display on, no args, w/delay
+    DELAY, //  1: Normal display on, no args, w/delay
     10,    //     10 ms delay
     ST7735_DISPON,
-    DELAY, //  4: Main screen turn on, no args w/delay
+    DELAY, //  2: Main screen turn on, no args w/delay
     100    //     100 ms delay
 };
@@ -33,7 +33,11 @@ constexpr uint8_t ST7735_RAMWR = 0x2C;
 constexpr uint8_t ST7735_RAMRD = 0x2E;
 
 constexpr uint8_t ST7735_PTLAR = 0x30;
+constexpr uint8_t ST7735_IDMOFF = 0x38;
+constexpr uint8_t ST7735_IDMON = 0x39;
 constexpr uint8_t ST7735_COLMOD = 0x3A;
+constexpr uint8_t ST7735_COLMOD_12 = 0x03; /* RGB444, 3 bytes per 2 pixels */
+constexpr uint8_t ST7735_COLMOD_16 = 0x05; /* RGB565 */
 constexpr uint8_t ST7735_MADCTL = 0x36;
 
 constexpr uint8_t ST7735_FRMCTR1 = 0xB1;
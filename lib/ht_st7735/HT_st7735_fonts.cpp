@@ -10,8 +10,13 @@
  */
 
 #include "HT_st7735_fonts.hpp"
+#include <array>
 
-static const uint16_t Font7x10[] = {
+/* The tables below are the readable source, one uint16_t per glyph row with
+ * the leftmost pixel in the MSB. Only the bit-packed copies built from them
+ * at compile time end up in flash. */
+
+static constexpr uint16_t Font7x10[] = {
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // sp
     0x1000, 0x1000, 0x1000, 0x1000, 0x1000,
@@ -204,7 +209,7 @@ static const uint16_t Font7x10[] = {
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // ~
 };
 
-static const uint16_t Font11x18[] = {
+static constexpr uint16_t Font11x18[] = {
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // sp
@@ -492,7 +497,7 @@ static const uint16_t Font11x18[] = {
     0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // ~
 };
 
-static const uint16_t
+static constexpr uint16_t
     Font16x26[] =
         {
             0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
@@ -877,6 +882,69 @@ static const uint16_t
             0x0000, 0x0000, 0x0000, 0x0000, 0x0000, // Ascii = [~]
 };
 
-FontDef Font_7x10 = {7, 10, Font7x10};
-FontDef Font_11x18 = {11, 18, Font11x18};
-FontDef Font_16x26 = {16, 26, Font16x26};
+constexpr size_t FONT_GLYPHS = '~' - ' ' + 1;
+/* The blitters read 3 bytes per row, the last row may run past its glyph */
+constexpr size_t FONT_PADDING = 2;
+
+template <uint8_t W, uint8_t H>
+constexpr size_t packed_glyph_bytes()
+{
+    return (W * H + 7) / 8;
+}
+
+template <uint8_t W, uint8_t H, size_t N>
+constexpr std::array<uint8_t,
+                     FONT_GLYPHS * packed_glyph_bytes<W, H>() + FONT_PADDING>
+pack_font(const uint16_t (&rows)[N])
+{
+    static_assert(N == FONT_GLYPHS * H, "Font table size mismatch");
+    std::array<uint8_t, FONT_GLYPHS * packed_glyph_bytes<W, H>() +
+                            FONT_PADDING>
+        packed{};
+    for (size_t g = 0; g < FONT_GLYPHS; g++)
+    {
+        const size_t base = g * packed_glyph_bytes<W, H>() * 8;
+        for (size_t i = 0; i < H; i++)
+        {
+            for (size_t j = 0; j < W; j++)
+            {
+                if (!(rows[g * H + i] & (0x8000 >> j)))
+                    continue;
+                const size_t bit = base + i * W + j;
+                packed[bit / 8] |= 0x80 >> (bit % 8);
+            }
+        }
+    }
+    return packed;
+}
+
+template <uint8_t W, uint8_t H>
+static void blit_glyph(const uint8_t* glyph, uint16_t first_row,
+                       uint16_t rows, uint16_t fg, uint16_t bg, uint16_t* dst,
+                       size_t stride)
+{
+    static_assert(W <= 16, "A glyph row has to fit in a 3 byte window");
+    for (uint16_t i = first_row; i < first_row + rows; i++, dst += stride)
+    {
+        const uint32_t bit = i * W;
+        const uint8_t* b = glyph + bit / 8;
+        const uint32_t window = (static_cast<uint32_t>(b[0]) << 24) |
+                                (static_cast<uint32_t>(b[1]) << 16) |
+                                (static_cast<uint32_t>(b[2]) << 8);
+        const uint32_t row = window << (bit % 8);
+        /* W is a constant, so this unrolls into W selects */
+        for (uint8_t j = 0; j < W; j++)
+            dst[j] = ((row << j) & 0x80000000) ? fg : bg;
+    }
+}
+
+static constexpr auto Font7x10_bits = pack_font<7, 10>(Font7x10);
+static constexpr auto Font11x18_bits = pack_font<11, 18>(Font11x18);
+static constexpr auto Font16x26_bits = pack_font<16, 26>(Font16x26);
+
+FontDef Font_7x10 = {7, 10, Font7x10_bits.data(),
+                     packed_glyph_bytes<7, 10>(), blit_glyph<7, 10>};
+FontDef Font_11x18 = {11, 18, Font11x18_bits.data(),
+                      packed_glyph_bytes<11, 18>(), blit_glyph<11, 18>};
+FontDef Font_16x26 = {16, 26, Font16x26_bits.data(),
+                      packed_glyph_bytes<16, 26>(), blit_glyph<16, 26>};
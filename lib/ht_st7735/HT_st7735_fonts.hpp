@@ -11,15 +11,30 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
+/* Expand rows [first_row, first_row + rows) of a glyph into pixels, writing
+ * fg/bg as given. Consecutive rows are stride pixels apart in dst */
+typedef void (*st7735_blit_fn)(const uint8_t* glyph, uint16_t first_row,
+                               uint16_t rows, uint16_t fg, uint16_t bg,
+                               uint16_t* dst, size_t stride);
+
 typedef struct
 {
     const uint8_t width;
     uint8_t height;
-    const uint16_t* data;
+    const uint8_t* data;  /* Glyphs from ' ' to '~', bit-packed row-major */
+    uint8_t glyph_bytes;  /* Bytes per packed glyph */
+    st7735_blit_fn blit;  /* Blitter specialised for width x height */
 } FontDef;
 
+/** @brief The packed bits of a glyph, to be passed to FontDef::blit */
+inline const uint8_t* st7735_glyph(const FontDef& f, char ch)
+{
+    return f.data + (ch - 32) * f.glyph_bytes;
+}
+
 extern FontDef Font_7x10;
 extern FontDef Font_11x18;
 extern FontDef Font_16x26;
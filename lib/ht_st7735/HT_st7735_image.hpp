@@ -0,0 +1,92 @@
+/**
+ * @file HT_st7735_image.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Palette plus run-length compressed images and their streaming
+ * decoder
+ * @version 0.1
+ * @date 2025-07-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * The pixels are a sequence of runs in row-major order. Each run starts with
+ * a byte holding the palette index in the high nibble and the length minus
+ * one in the low nibble. A low nibble of 15 means that the length is 16 plus
+ * the next byte. Images are generated by scripts/rle_image.py.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+constexpr uint8_t ST7735_IMAGE_MAX_COLORS = 16;
+constexpr uint8_t ST7735_IMAGE_LONG_RUN = 0x0F;
+
+typedef struct
+{
+    uint8_t width;
+    uint8_t height;
+    uint8_t palette_size;    /* Up to ST7735_IMAGE_MAX_COLORS */
+    const uint16_t* palette; /* RGB565 */
+    const uint8_t* rle;      /* Runs, see above */
+    uint16_t rle_bytes;
+} st7735_image_t;
+
+/**
+ * @brief Expands an image into panel byte order pixels a chunk at a time, so
+ * that it can be streamed through a buffer smaller than the image.
+ */
+class st7735_image_decoder
+{
+public:
+    explicit st7735_image_decoder(const st7735_image_t& image) : _image(image)
+    {
+        const uint8_t n = std::min(image.palette_size, ST7735_IMAGE_MAX_COLORS);
+        for (uint8_t i = 0; i < n; i++)
+        {
+            const uint16_t c = image.palette[i];
+            _colors[i] = static_cast<uint16_t>((c >> 8) | (c << 8));
+        }
+    }
+
+    /**
+     * @brief Decode the next pixels of the image.
+     *
+     * @param dst
+     * @param n the number of pixels wanted
+     * @return size_t the number of pixels written, less than n only at the
+     * end of the image
+     */
+    size_t read(uint16_t* dst, size_t n)
+    {
+        size_t done = 0;
+        while (done < n)
+        {
+            if (!_left)
+            {
+                if (_pos >= _image.rle_bytes)
+                    break;
+                const uint8_t b = _image.rle[_pos++];
+                _color = _colors[b >> 4];
+                _left = (b & 0x0F) + 1;
+                if ((b & 0x0F) == ST7735_IMAGE_LONG_RUN &&
+                    _pos < _image.rle_bytes)
+                    _left = ST7735_IMAGE_LONG_RUN + 1 + _image.rle[_pos++];
+                continue;
+            }
+            const size_t k = std::min<size_t>(_left, n - done);
+            std::fill_n(dst + done, k, _color);
+            done += k;
+            _left -= k;
+        }
+        return done;
+    }
+
+private:
+    const st7735_image_t& _image;
+    uint16_t _colors[ST7735_IMAGE_MAX_COLORS] = {}; /* Panel byte order */
+    size_t _pos = 0;    /* Next run to read */
+    uint16_t _left = 0; /* Pixels left in the current run */
+    uint16_t _color = 0;
+};
@@ -0,0 +1,429 @@
+/**
+ * @file HT_st7735_renderer.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Render task that owns the ST7735
+ * @version 0.1
+ * @date 2025-07-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "HT_st7735_renderer.hpp"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <algorithm>
+#include <cstring>
+
+static const char* TAG = "st7735_render";
+
+/* Area a pixel command paints over completely. Commands whose extent is not
+ * known, like wrapping text, report none and are never dropped */
+static bool opaque_area(const st7735_render_cmd_t& c, st7735_rect_t& r)
+{
+    uint16_t w = c.w, h = c.h;
+    switch (c.op)
+    {
+        case ST7735_RENDER_FILL:
+            break;
+        case ST7735_RENDER_TEXT:
+        {
+            const FontDef* f = static_cast<const FontDef*>(c.ptr);
+            if (strchr(c.text, '\n'))
+                return false;
+            w = strlen(c.text) * f->width;
+            h = f->height;
+            if (c.x + w > ST7735_WIDTH)
+                return false;
+            break;
+        }
+        case ST7735_RENDER_IMAGE:
+        case ST7735_RENDER_RLE_IMAGE:
+            /* draw_image() skips images that do not fit */
+            if (c.x + w > ST7735_WIDTH || c.y + h > ST7735_HEIGHT)
+                return false;
+            break;
+        default:
+            return false;
+    }
+    if (c.x >= ST7735_WIDTH || c.y >= ST7735_HEIGHT || !w || !h)
+        return false;
+    r = {c.x, c.y,
+         (uint16_t)(std::min<uint16_t>(c.x + w, ST7735_WIDTH) - 1),
+         (uint16_t)(std::min<uint16_t>(c.y + h, ST7735_HEIGHT) - 1)};
+    return true;
+}
+
+esp_err_t HT_st7735_renderer::init(HT_st7735* display)
+{
+    _display = display;
+    _queue = xQueueCreate(ST7735_RENDER_QUEUE_LEN, sizeof(st7735_render_cmd_t));
+    if (!_queue)
+    {
+        ESP_LOGE(TAG, "Failed to create the render queue");
+        return ESP_ERR_NO_MEM;
+    }
+    _cells.init(display);
+    return ESP_OK;
+}
+
+void HT_st7735_renderer::post(const st7735_render_cmd_t& c)
+{
+    xQueueSend(_queue, &c, portMAX_DELAY);
+}
+
+void HT_st7735_renderer::fill_rectangle(uint16_t x, uint16_t y, uint16_t w,
+                                        uint16_t h, uint16_t color)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_FILL;
+    c.x = x;
+    c.y = y;
+    c.w = w;
+    c.h = h;
+    c.color = color;
+    post(c);
+}
+
+void HT_st7735_renderer::write_str(uint16_t x, uint16_t y, const char* str,
+                                   const FontDef& font, uint16_t color,
+                                   uint16_t bgcolor)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_TEXT;
+    c.x = x;
+    c.y = y;
+    c.color = color;
+    c.bgcolor = bgcolor;
+    c.ptr = &font;
+    strncpy(c.text, str, sizeof(c.text) - 1);
+    post(c);
+}
+
+void HT_st7735_renderer::draw_image(uint16_t x, uint16_t y, uint16_t w,
+                                    uint16_t h, const uint16_t* data)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_IMAGE;
+    c.x = x;
+    c.y = y;
+    c.w = w;
+    c.h = h;
+    c.ptr = data;
+    post(c);
+}
+
+void HT_st7735_renderer::draw_image(uint16_t x, uint16_t y,
+                                    const st7735_image_t& image)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_RLE_IMAGE;
+    c.x = x;
+    c.y = y;
+    c.w = image.width;
+    c.h = image.height;
+    c.ptr = &image;
+    post(c);
+}
+
+uint8_t HT_st7735_renderer::print(uint8_t col, uint8_t row, const char* str,
+                                  uint16_t color, uint16_t bgcolor)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_CELLS_PRINT;
+    c.x = col;
+    c.y = row;
+    c.color = color;
+    c.bgcolor = bgcolor;
+    strncpy(c.text, str, sizeof(c.text) - 1);
+    post(c);
+    /* Mirror the clipping of the layer, so that callers can keep writing */
+    return std::min<size_t>(col + strlen(c.text), ST7735_TEXT_COLUMNS);
+}
+
+uint8_t HT_st7735_renderer::arrow(uint8_t col, uint8_t row, uint8_t dir,
+                                  uint16_t color, uint16_t bgcolor)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_CELLS_ARROW;
+    c.x = col;
+    c.y = row;
+    c.w = dir;
+    c.color = color;
+    c.bgcolor = bgcolor;
+    post(c);
+    return col + 1 < ST7735_TEXT_COLUMNS ? col + 2 : col;
+}
+
+void HT_st7735_renderer::fill_cells(uint8_t col, uint8_t row, uint8_t n,
+                                    uint16_t bgcolor)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_CELLS_FILL;
+    c.x = col;
+    c.y = row;
+    c.w = n;
+    c.bgcolor = bgcolor;
+    post(c);
+}
+
+void HT_st7735_renderer::reset_cells(uint16_t bgcolor)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_CELLS_RESET;
+    c.bgcolor = bgcolor;
+    post(c);
+}
+
+void HT_st7735_renderer::set_backlight(uint8_t percent, uint16_t fade_ms)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_BACKLIGHT;
+    c.w = fade_ms;
+    c.bgcolor = percent;
+    post(c);
+}
+
+void HT_st7735_renderer::turn_on()
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_POWER;
+    c.bgcolor = true;
+    post(c);
+}
+
+void HT_st7735_renderer::turn_off(uint16_t expected_s)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_POWER;
+    c.w = expected_s;
+    c.bgcolor = false;
+    post(c);
+}
+
+void HT_st7735_renderer::set_idle_mode(bool enable)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_IDLE_MODE;
+    c.bgcolor = enable;
+    post(c);
+}
+
+void HT_st7735_renderer::set_partial_area(uint16_t x0, uint16_t x1)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_PARTIAL_AREA;
+    c.x = x0;
+    c.w = x1;
+    post(c);
+}
+
+void HT_st7735_renderer::set_partial_mode(bool enable)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_PARTIAL_MODE;
+    c.bgcolor = enable;
+    post(c);
+}
+
+void HT_st7735_renderer::end_frame(bool wait)
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_FRAME;
+    c.ptr = wait ? xTaskGetCurrentTaskHandle() : nullptr;
+    post(c);
+    if (wait)
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+}
+
+size_t HT_st7735_renderer::sync()
+{
+    st7735_render_cmd_t c = {};
+    c.op = ST7735_RENDER_SYNC;
+    c.ptr = xTaskGetCurrentTaskHandle();
+    post(c);
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return _synced;
+}
+
+void HT_st7735_renderer::run()
+{
+    st7735_render_cmd_t c;
+    while (true)
+    {
+        if (xQueueReceive(_queue, &c, portMAX_DELAY) != pdTRUE)
+            continue;
+        _stats.commands++;
+        /* A reset only tells the layer what the panel already shows */
+        if (c.op != ST7735_RENDER_FRAME && c.op != ST7735_RENDER_SYNC &&
+            c.op != ST7735_RENDER_CELLS_RESET)
+            _unframed++;
+        switch (c.op)
+        {
+            /* The text layer diffs on its own, so its commands only update
+             * the model */
+            case ST7735_RENDER_CELLS_PRINT:
+                _cells.print(c.x, c.y, c.text, c.color, c.bgcolor);
+                break;
+            case ST7735_RENDER_CELLS_ARROW:
+                _cells.arrow(c.x, c.y, c.w, c.color, c.bgcolor);
+                break;
+            case ST7735_RENDER_CELLS_FILL:
+                _cells.fill(c.x, c.y, c.w, c.bgcolor);
+                break;
+            case ST7735_RENDER_CELLS_RESET:
+                _cells.init(_display, c.bgcolor);
+                break;
+            case ST7735_RENDER_FRAME:
+                render_frame(static_cast<TaskHandle_t>(
+                    const_cast<void*>(c.ptr)));
+                break;
+            case ST7735_RENDER_SYNC:
+                _synced = _unframed;
+                xTaskNotifyGive(
+                    static_cast<TaskHandle_t>(const_cast<void*>(c.ptr)));
+                break;
+            default:
+                push(c);
+                break;
+        }
+    }
+}
+
+void HT_st7735_renderer::push(const st7735_render_cmd_t& c)
+{
+    if (_n_ops == ST7735_RENDER_MAX_OPS)
+    {
+        /* Run what we have so far, the frame goes out in two parts */
+        _display->unhold_pins();
+        execute();
+        _display->hold_pins();
+    }
+    _ops[_n_ops++] = c;
+}
+
+void HT_st7735_renderer::execute()
+{
+    st7735_rect_t mine, later;
+    for (size_t i = 0; i < _n_ops; i++)
+    {
+        const st7735_render_cmd_t& c = _ops[i];
+
+        /* Skip the commands that a later one overwrites anyway */
+        bool hidden = false;
+        if (opaque_area(c, mine))
+        {
+            for (size_t j = i + 1; j < _n_ops && !hidden; j++)
+                hidden = opaque_area(_ops[j], later) && later.x0 <= mine.x0 &&
+                         later.y0 <= mine.y0 && later.x1 >= mine.x1 &&
+                         later.y1 >= mine.y1;
+        }
+        else if (c.op == ST7735_RENDER_BACKLIGHT)
+        {
+            for (size_t j = i + 1; j < _n_ops && !hidden; j++)
+                hidden = _ops[j].op == ST7735_RENDER_BACKLIGHT;
+        }
+        if (hidden)
+        {
+            _stats.coalesced++;
+            continue;
+        }
+
+        switch (c.op)
+        {
+            case ST7735_RENDER_FILL:
+                _display->fill_rectangle(c.x, c.y, c.w, c.h, c.color);
+                break;
+            case ST7735_RENDER_TEXT:
+                _display->write_str(c.x, c.y, c.text,
+                                    *static_cast<const FontDef*>(c.ptr),
+                                    c.color, c.bgcolor);
+                break;
+            case ST7735_RENDER_IMAGE:
+                _display->draw_image(c.x, c.y, c.w, c.h,
+                                     static_cast<const uint16_t*>(c.ptr));
+                break;
+            case ST7735_RENDER_RLE_IMAGE:
+                _display->draw_image(
+                    c.x, c.y, *static_cast<const st7735_image_t*>(c.ptr));
+                break;
+            case ST7735_RENDER_BACKLIGHT:
+                _display->set_backlight(c.bgcolor, c.w);
+                break;
+            case ST7735_RENDER_POWER:
+                /* Both wait for the end of the frame, the last one wins */
+                _wake = c.bgcolor;
+                _sleep = !c.bgcolor;
+                _sleep_s = c.w;
+                break;
+            case ST7735_RENDER_IDLE_MODE:
+                _display->set_idle_mode(c.bgcolor);
+                break;
+            case ST7735_RENDER_PARTIAL_AREA:
+                _display->set_partial_area(c.x, c.w);
+                break;
+            case ST7735_RENDER_PARTIAL_MODE:
+                _display->set_partial_mode(c.bgcolor);
+                break;
+            default:
+                break;
+        }
+    }
+    _n_ops = 0;
+}
+
+void HT_st7735_renderer::render_frame(TaskHandle_t notify)
+{
+    const int64_t start = esp_timer_get_time();
+    const st7735_stats_t before = _display->get_stats();
+    _display->unhold_pins();
+    execute();
+    _cells.render();
+    _display->flush();
+    _unframed = 0;
+    /* The panel kept its memory while off, with the changes of this frame
+     * written to it the screen is complete the moment it is shown. It goes
+     * off only once the changes of the frame are on it as well, which the
+     * text layer already counts as shown */
+    if (_wake)
+    {
+        _display->turn_on();
+        _wake = false;
+    }
+    else if (_sleep)
+    {
+        _display->turn_off_for(_sleep_s * 1000u);
+        _sleep = false;
+    }
+    _display->hold_pins();
+
+    const int64_t cost = esp_timer_get_time() - start;
+    const st7735_stats_t after = _display->get_stats();
+    _stats.frames++;
+    _stats.last_frame_us = cost;
+    _stats.max_frame_us = std::max(_stats.max_frame_us, cost);
+    _stats.total_frame_us += cost;
+    _stats.last_frame_spi = {
+        after.blocked_us - before.blocked_us,
+        after.commands - before.commands,
+        after.transactions - before.transactions,
+        after.bytes - before.bytes,
+        after.skipped - before.skipped,
+    };
+    ESP_LOGD(TAG,
+             "Frame %lu took %lld us: %lu commands, %lu transactions, "
+             "%lu bytes, %lu CASET/RASET skipped",
+             _stats.frames, cost, _stats.last_frame_spi.commands,
+             _stats.last_frame_spi.transactions, _stats.last_frame_spi.bytes,
+             _stats.last_frame_spi.skipped);
+
+    if (notify)
+        xTaskNotifyGive(notify);
+}
+
+void display_render_task(void* args)
+{
+    HT_st7735_renderer* renderer = static_cast<HT_st7735_renderer*>(args);
+    ESP_LOGI(TAG, "Display render task started");
+    renderer->run();
+}
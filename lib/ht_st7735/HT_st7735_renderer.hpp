@@ -0,0 +1,170 @@
+/**
+ * @file HT_st7735_renderer.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Render task that owns the ST7735. Other tasks post typed draw
+ * commands to its queue and the task executes them a frame at a time.
+ * @version 0.1
+ * @date 2025-07-24
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include "HT_st7735.hpp"
+#include "HT_st7735_text_layer.hpp"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+
+#ifndef ST7735_RENDER_QUEUE_LEN
+#define ST7735_RENDER_QUEUE_LEN 32
+#endif
+
+/* Pixel commands buffered per frame, a longer frame is executed in parts */
+constexpr size_t ST7735_RENDER_MAX_OPS = 24;
+/* Longest string carried by a text command, including the terminator */
+constexpr size_t ST7735_RENDER_TEXT_LEN = 64;
+
+typedef enum
+{
+    ST7735_RENDER_FILL,         /* fill_rectangle() */
+    ST7735_RENDER_TEXT,         /* write_str() */
+    ST7735_RENDER_IMAGE,        /* draw_image() */
+    ST7735_RENDER_RLE_IMAGE,    /* draw_image() of a compressed image */
+    ST7735_RENDER_CELLS_PRINT,  /* Text layer print() */
+    ST7735_RENDER_CELLS_ARROW,  /* Text layer arrow() */
+    ST7735_RENDER_CELLS_FILL,   /* Text layer fill() */
+    ST7735_RENDER_CELLS_RESET,  /* The panel was cleared under the layer */
+    ST7735_RENDER_BACKLIGHT,    /* set_backlight() */
+    ST7735_RENDER_POWER,        /* turn_on()/turn_off() */
+    ST7735_RENDER_IDLE_MODE,    /* set_idle_mode() */
+    ST7735_RENDER_PARTIAL_AREA, /* set_partial_area() */
+    ST7735_RENDER_PARTIAL_MODE, /* set_partial_mode() */
+    ST7735_RENDER_FRAME,        /* End of frame */
+    ST7735_RENDER_SYNC,         /* sync(), the frame stays open */
+} st7735_render_op_t;
+
+typedef struct
+{
+    st7735_render_op_t op;
+    uint16_t x, y; /* Pixels, or column/row for the cell commands */
+    uint16_t w, h; /* Pixels, the cells of CELLS_FILL, the arrow index,
+                      the backlight fade in ms or the off time in s */
+    uint16_t color;
+    uint16_t bgcolor; /* Also the on/off argument of the mode commands */
+    const void* ptr;  /* Font, image or the task to notify after a frame */
+    char text[ST7735_RENDER_TEXT_LEN];
+} st7735_render_cmd_t;
+
+typedef struct
+{
+    uint32_t frames;
+    uint32_t commands;  /* Commands received */
+    uint32_t coalesced; /* Commands dropped as a later one hid them */
+    int64_t last_frame_us;
+    int64_t max_frame_us;
+    int64_t total_frame_us;
+    st7735_stats_t last_frame_spi; /* SPI traffic of the last frame */
+} st7735_render_stats_t;
+
+class HT_st7735_renderer
+{
+public:
+    /**
+     * @brief Create the command queue. The display has to be initialised and
+     * must not be used directly once display_render_task runs.
+     *
+     * @param display
+     * @return esp_err_t ESP_ERR_NO_MEM if the queue cannot be created
+     */
+    esp_err_t init(HT_st7735* display);
+
+    /* Pixel commands, executed in order at the end of the frame */
+    void fill_rectangle(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                        uint16_t color);
+    void fill_screen(uint16_t color)
+    {
+        fill_rectangle(0, 0, ST7735_WIDTH, ST7735_HEIGHT, color);
+    }
+    /** @brief Strings longer than ST7735_RENDER_TEXT_LEN - 1 are truncated */
+    void write_str(uint16_t x, uint16_t y, const char* str, const FontDef& font,
+                   uint16_t color, uint16_t bgcolor);
+    /** @brief The pixels have to stay valid until the frame is rendered */
+    void draw_image(uint16_t x, uint16_t y, uint16_t w, uint16_t h,
+                    const uint16_t* data);
+    /** @brief The image and its palette have to stay valid as well */
+    void draw_image(uint16_t x, uint16_t y, const st7735_image_t& image);
+
+    /* Text layer commands, see HT_st7735_text_layer. The layer is drawn after
+     * the pixel commands of the frame */
+    uint8_t print(uint8_t col, uint8_t row, const char* str, uint16_t color,
+                  uint16_t bgcolor);
+    uint8_t arrow(uint8_t col, uint8_t row, uint8_t dir, uint16_t color,
+                  uint16_t bgcolor);
+    void fill_cells(uint8_t col, uint8_t row, uint8_t n, uint16_t bgcolor);
+    void clear_cells(uint8_t col, uint8_t row,
+                     uint16_t bgcolor = ST7735_BLACK)
+    {
+        fill_cells(col, row, ST7735_TEXT_COLUMNS - col, bgcolor);
+    }
+    /** @brief Tell the layer that the panel was cleared to bgcolor */
+    void reset_cells(uint16_t bgcolor = ST7735_BLACK);
+
+    /* Panel state commands, executed in order with the pixel commands.
+     * turn_on() and turn_off() are the exception, the panel is switched once
+     * the frame is flushed: on so that it lights up with the frame already
+     * in place, off so that the frame is not lost. turn_off() picks the
+     * power state from how long the panel is expected to stay off, see
+     * HT_st7735::turn_off_for() */
+    void set_backlight(uint8_t percent, uint16_t fade_ms = 0);
+    void turn_on();
+    void turn_off(uint16_t expected_s = 0);
+    void set_idle_mode(bool enable = true);
+    void set_partial_area(uint16_t x0, uint16_t x1);
+    void set_partial_mode(bool enable = true);
+
+    /**
+     * @brief Close the frame. The render task executes the frame's commands
+     * under a single pin unhold/hold and flushes the framebuffer.
+     *
+     * @param wait block until the frame is on the panel
+     */
+    void end_frame(bool wait = false);
+
+    /**
+     * @brief Wait for the render task to take every command posted so far,
+     * without closing the frame. Lets a test find the commands that no
+     * frame sent.
+     *
+     * @return size_t commands taken since the last frame
+     */
+    size_t sync();
+
+    /** @brief Frame statistics since boot */
+    st7735_render_stats_t get_stats() const { return _stats; }
+
+    /** @brief Consume the queue forever, called by display_render_task */
+    void run();
+
+private:
+    void post(const st7735_render_cmd_t& c);
+    void push(const st7735_render_cmd_t& c);
+    void execute();
+    void render_frame(TaskHandle_t notify);
+
+    HT_st7735* _display = nullptr;
+    QueueHandle_t _queue = nullptr;
+    HT_st7735_text_layer _cells;
+    st7735_render_cmd_t _ops[ST7735_RENDER_MAX_OPS]; /* Pending frame */
+    size_t _n_ops = 0;
+    bool _wake = false;    /* turn_on() at the end of the frame */
+    bool _sleep = false;   /* turn_off() at the end of the frame */
+    uint16_t _sleep_s = 0; /* The off time expected by turn_off() */
+    size_t _unframed = 0; /* Commands taken since the last frame */
+    size_t _synced = 0;   /* _unframed at the last sync() */
+    st7735_render_stats_t _stats = {};
+};
+
+void display_render_task(void* args);
@@ -0,0 +1,92 @@
+/**
+ * @file HT_st7735_sprite.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Run-length compressed two-colour sprites and their streaming decoder
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * A sprite is a sequence of runs over its pixels in row-major order. The runs
+ * alternate between the background and the foreground, starting with the
+ * background, and each is a nibble, high nibble first. Longer runs are split
+ * by an empty run of the other colour.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+typedef struct
+{
+    uint8_t width;
+    uint8_t height;
+    const uint8_t* rle; /* Packed runs, see above */
+    uint16_t rle_bytes;
+} st7735_sprite_t;
+
+/* Direction arrows, generated by scripts/arrow_atlas.py. Arrow i points
+ * i * 22.5 degrees clockwise from up and spans two Font_7x10 cells */
+constexpr uint8_t ST7735_ARROW_WIDTH = 14;
+constexpr uint8_t ST7735_ARROW_HEIGHT = 10;
+constexpr uint8_t ST7735_ARROW_COUNT = 16;
+extern const st7735_sprite_t st7735_arrows[ST7735_ARROW_COUNT];
+
+/**
+ * @brief Expands a sprite into pixels a chunk at a time, so that it can be
+ * streamed through a buffer smaller than the sprite.
+ */
+class st7735_rle_decoder
+{
+public:
+    /**
+     * @param sprite
+     * @param color the foreground, in the byte order of the destination
+     * @param bgcolor the background, in the byte order of the destination
+     */
+    st7735_rle_decoder(const st7735_sprite_t& sprite, uint16_t color,
+                       uint16_t bgcolor)
+        : _sprite(sprite), _colors{bgcolor, color}
+    {
+    }
+
+    /**
+     * @brief Decode the next pixels of the sprite.
+     *
+     * @param dst
+     * @param n the number of pixels wanted
+     * @return size_t the number of pixels written, less than n only at the
+     * end of the sprite
+     */
+    size_t read(uint16_t* dst, size_t n)
+    {
+        size_t done = 0;
+        while (done < n)
+        {
+            if (!_left)
+            {
+                if (_nibble >= _sprite.rle_bytes * 2u)
+                    break;
+                const uint8_t b = _sprite.rle[_nibble / 2];
+                _left = (_nibble & 1) ? (b & 0x0F) : (b >> 4);
+                _fg = _nibble & 1;
+                _nibble++;
+                continue;
+            }
+            const size_t k = std::min<size_t>(_left, n - done);
+            std::fill_n(dst + done, k, _colors[_fg]);
+            done += k;
+            _left -= k;
+        }
+        return done;
+    }
+
+private:
+    const st7735_sprite_t& _sprite;
+    const uint16_t _colors[2]; /* Background, foreground */
+    size_t _nibble = 0;        /* Next run to read */
+    uint8_t _left = 0;         /* Pixels left in the current run */
+    uint8_t _fg = 0;           /* Whether the current run is foreground */
+};
@@ -0,0 +1,207 @@
+/**
+ * @file HT_st7735_text_layer.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Character-cell text layer on top of the ST7735 driver
+ * @version 0.1
+ * @date 2025-07-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "HT_st7735_text_layer.hpp"
+#include <algorithm>
+
+constexpr uint16_t ST7735_TEXT_MARGIN =
+    ST7735_WIDTH - ST7735_TEXT_COLUMNS * ST7735_TEXT_CELL_WIDTH;
+
+void HT_st7735_text_layer::init(HT_st7735* display, uint16_t bg)
+{
+    _display = display;
+    for (uint8_t row = 0; row < ST7735_TEXT_ROWS; row++)
+    {
+        for (uint8_t col = 0; col < ST7735_TEXT_COLUMNS; col++)
+        {
+            _cells[row][col] = {' ', bg, bg};
+            _shown[row][col] = {' ', bg, bg};
+        }
+        _margin[row] = bg;
+        _margin_valid[row] = true;
+    }
+}
+
+uint8_t HT_st7735_text_layer::print(uint8_t col, uint8_t row, const char* s,
+                                    uint16_t fg, uint16_t bg)
+{
+    if (row >= ST7735_TEXT_ROWS)
+        return col;
+    for (; *s && col < ST7735_TEXT_COLUMNS; s++, col++)
+        _cells[row][col] = {*s, fg, bg};
+    return col;
+}
+
+uint8_t HT_st7735_text_layer::arrow(uint8_t col, uint8_t row, uint8_t dir,
+                                    uint16_t fg, uint16_t bg)
+{
+    if (row >= ST7735_TEXT_ROWS || col + 1 >= ST7735_TEXT_COLUMNS)
+        return col;
+    const char head = ST7735_TEXT_ARROW + dir % ST7735_ARROW_COUNT;
+    _cells[row][col] = {head, fg, bg};
+    _cells[row][col + 1] = {(char)ST7735_TEXT_ARROW_TAIL, fg, bg};
+    return col + 2;
+}
+
+void HT_st7735_text_layer::fill(uint8_t col, uint8_t row, uint8_t n,
+                                uint16_t bg)
+{
+    if (row >= ST7735_TEXT_ROWS)
+        return;
+    for (; n && col < ST7735_TEXT_COLUMNS; n--, col++)
+        _cells[row][col] = {' ', bg, bg};
+}
+
+void HT_st7735_text_layer::invalidate()
+{
+    for (uint8_t row = 0; row < ST7735_TEXT_ROWS; row++)
+    {
+        for (uint8_t col = 0; col < ST7735_TEXT_COLUMNS; col++)
+            _shown[row][col].ch = '\0';
+        _margin_valid[row] = false;
+    }
+}
+
+void HT_st7735_text_layer::render()
+{
+    for (uint8_t row = 0; row < ST7735_TEXT_ROWS; row++)
+        collect_row(row);
+    send_bands();
+}
+
+void HT_st7735_text_layer::collect_row(uint8_t row)
+{
+    const st7735_cell_t* cells = _cells[row];
+    st7735_cell_t* shown = _shown[row];
+
+    /* Both halves of an arrow that was broken up have to be redrawn */
+    for (uint8_t col = 0; col < ST7735_TEXT_COLUMNS; col++)
+    {
+        if (is_arrow(shown, col) && !is_arrow(cells, col))
+            shown[col].ch = shown[col + 1].ch = '\0';
+    }
+
+    /* The margin follows the background of the last column, it is an extra
+     * cell at the end of the row */
+    bool changed[ST7735_TEXT_COLUMNS + 1];
+    for (uint8_t col = 0; col < ST7735_TEXT_COLUMNS; col++)
+        changed[col] = !same(cells[col], shown[col]);
+    const uint16_t margin = cells[ST7735_TEXT_COLUMNS - 1].bg;
+    changed[ST7735_TEXT_COLUMNS] =
+        !_margin_valid[row] || _margin[row] != margin;
+    for (uint8_t col = 0; col < ST7735_TEXT_COLUMNS; col++)
+    {
+        if (is_arrow(cells, col) && (changed[col] || changed[col + 1]))
+            changed[col] = changed[col + 1] = true;
+    }
+
+    uint8_t col = 0;
+    while (col <= ST7735_TEXT_COLUMNS)
+    {
+        if (!changed[col])
+        {
+            col++;
+            continue;
+        }
+        /* Grow the band, bridging short gaps of cells that did not change */
+        const uint8_t start = col;
+        uint8_t end = col + 1;
+        for (uint8_t scan = end;
+             scan <= ST7735_TEXT_COLUMNS && scan - end <= ST7735_TEXT_MERGE_GAP;
+             scan++)
+        {
+            if (changed[scan])
+                end = scan + 1;
+        }
+        add_band(row, start, end);
+        col = end;
+    }
+    for (uint8_t i = 0; i < ST7735_TEXT_COLUMNS; i++)
+        shown[i] = cells[i];
+    _margin[row] = margin;
+    _margin_valid[row] = true;
+}
+
+void HT_st7735_text_layer::add_band(uint8_t row, uint8_t start, uint8_t end)
+{
+    if (_n_bands == ST7735_TEXT_MAX_BANDS)
+        send_bands();
+    /* A band ending after the last column takes the margin as well */
+    st7735_rect_t& band = _bands[_n_bands++];
+    band.x0 = start * ST7735_TEXT_CELL_WIDTH;
+    band.y0 = row * ST7735_TEXT_CELL_HEIGHT;
+    band.x1 = end > ST7735_TEXT_COLUMNS ? ST7735_WIDTH - 1
+                                        : end * ST7735_TEXT_CELL_WIDTH - 1;
+    band.y1 = band.y0 + ST7735_TEXT_CELL_HEIGHT - 1;
+}
+
+void HT_st7735_text_layer::send_bands()
+{
+    if (!_n_bands)
+        return;
+    _display->draw_bands(_bands, _n_bands, compose, this,
+                         ST7735_TEXT_CELL_WIDTH);
+    _n_bands = 0;
+}
+
+void HT_st7735_text_layer::compose(void* ctx, size_t band, uint16_t* pixels)
+{
+    const HT_st7735_text_layer* layer =
+        static_cast<const HT_st7735_text_layer*>(ctx);
+    layer->compose_band(layer->_bands[band], pixels);
+}
+
+void HT_st7735_text_layer::compose_band(const st7735_rect_t& band,
+                                        uint16_t* pixels) const
+{
+    const uint8_t row = band.y0 / ST7735_TEXT_CELL_HEIGHT;
+    const st7735_cell_t* cells = _cells[row];
+    const uint16_t w = band.x1 - band.x0 + 1;
+    const uint8_t h = ST7735_TEXT_CELL_HEIGHT;
+
+    uint8_t col = band.x0 / ST7735_TEXT_CELL_WIDTH;
+    for (; col < ST7735_TEXT_COLUMNS &&
+           col * ST7735_TEXT_CELL_WIDTH <= band.x1;
+         col++)
+    {
+        const st7735_cell_t& c = cells[col];
+        uint16_t* dst = pixels + col * ST7735_TEXT_CELL_WIDTH - band.x0;
+        const uint16_t fg = HT_st7735::swap565(c.fg);
+        const uint16_t bg = HT_st7735::swap565(c.bg);
+        if (is_arrow(cells, col))
+        {
+            /* A band never starts or ends inside an arrow */
+            const uint8_t dir =
+                static_cast<uint8_t>(c.ch) - ST7735_TEXT_ARROW;
+            st7735_rle_decoder src(st7735_arrows[dir], fg, bg);
+            for (uint8_t i = 0; i < h; i++)
+                src.read(dst + i * w, ST7735_ARROW_WIDTH);
+            col++;
+            continue;
+        }
+        if (c.ch == ' ' || is_sprite(c.ch))
+        {
+            for (uint8_t i = 0; i < h; i++)
+                std::fill_n(dst + i * w, ST7735_TEXT_CELL_WIDTH, bg);
+            continue;
+        }
+        Font_7x10.blit(st7735_glyph(Font_7x10, c.ch), 0, h, fg, bg, dst, w);
+    }
+
+    if (band.x1 >= ST7735_WIDTH - ST7735_TEXT_MARGIN)
+    {
+        const uint16_t margin =
+            HT_st7735::swap565(cells[ST7735_TEXT_COLUMNS - 1].bg);
+        uint16_t* dst = pixels + ST7735_WIDTH - ST7735_TEXT_MARGIN - band.x0;
+        for (uint8_t i = 0; i < h; i++)
+            std::fill_n(dst + i * w, ST7735_TEXT_MARGIN, margin);
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * @file HT_st7735_text_layer.hpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Character-cell text layer on top of the ST7735 driver. Only the cells
+ * whose glyph or colours changed since the last render reach the panel.
+ * @version 0.1
+ * @date 2025-07-21
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#pragma once
+
+#include "HT_st7735.hpp"
+
+/* The layer uses Font_7x10 cells: 22 columns, 8 rows and a 6 pixel margin */
+constexpr uint8_t ST7735_TEXT_CELL_WIDTH = 7;
+constexpr uint8_t ST7735_TEXT_CELL_HEIGHT = 10;
+constexpr uint8_t ST7735_TEXT_COLUMNS = ST7735_WIDTH / ST7735_TEXT_CELL_WIDTH;
+constexpr uint8_t ST7735_TEXT_ROWS = ST7735_HEIGHT / ST7735_TEXT_CELL_HEIGHT;
+
+/* Changed cells separated by up to this many unchanged cells are composed
+ * into the same band, it is cheaper than another address window */
+constexpr uint8_t ST7735_TEXT_MERGE_GAP = 2;
+
+/* Bands collected before they are handed to the display */
+constexpr size_t ST7735_TEXT_MAX_BANDS = 16;
+
+/* An arrow takes two cells, a head holding ST7735_TEXT_ARROW + direction and
+ * a tail. Either of them on its own shows as a blank cell */
+constexpr uint8_t ST7735_TEXT_ARROW = 0x80;
+constexpr uint8_t ST7735_TEXT_ARROW_TAIL = 0x7F;
+
+typedef struct
+{
+    char ch;
+    uint16_t fg;
+    uint16_t bg;
+} st7735_cell_t;
+
+class HT_st7735_text_layer
+{
+public:
+    /**
+     * @brief Attach the layer to a display. The panel is assumed to be
+     * cleared to bgcolor.
+     *
+     * @param display
+     * @param bgcolor
+     */
+    void init(HT_st7735* display, uint16_t bgcolor = ST7735_BLACK);
+
+    /**
+     * @brief Write a string starting at the given cell. The string is clipped
+     * at the end of the row.
+     *
+     * @return uint8_t the column right after the string
+     */
+    uint8_t print(uint8_t col, uint8_t row, const char* str, uint16_t color,
+                  uint16_t bgcolor);
+
+    /**
+     * @brief Draw one of the st7735_arrows sprites over two cells.
+     *
+     * @param dir the arrow index, i * 22.5 degrees clockwise from up
+     * @return uint8_t the column right after the arrow, col if it does not fit
+     */
+    uint8_t arrow(uint8_t col, uint8_t row, uint8_t dir, uint16_t color,
+                  uint16_t bgcolor);
+
+    /**
+     * @brief Blank n cells with the given background. If the last column is
+     * reached, the margin at the right of the row takes the colour as well.
+     */
+    void fill(uint8_t col, uint8_t row, uint8_t n, uint16_t bgcolor);
+
+    /** @brief Blank the row from col up to and including the margin */
+    void clear(uint8_t col, uint8_t row, uint16_t bgcolor = ST7735_BLACK)
+    {
+        fill(col, row, ST7735_TEXT_COLUMNS - col, bgcolor);
+    }
+
+    /**
+     * @brief Send the cells that changed since the last render to the display.
+     * The changed cells of a row are composed into bands one text row high,
+     * see HT_st7735::draw_bands(), so that text, arrows and fills of a row
+     * go out together. The caller is responsible for the display pins.
+     */
+    void render();
+
+    /** @brief Forget what the panel shows, the next render redraws all */
+    void invalidate();
+
+private:
+    static bool same(const st7735_cell_t& a, const st7735_cell_t& b)
+    {
+        /* The foreground of a blank cell is invisible */
+        return a.ch == b.ch && a.bg == b.bg && (a.ch == ' ' || a.fg == b.fg);
+    }
+    static bool is_sprite(char ch)
+    {
+        return static_cast<uint8_t>(ch) >= ST7735_TEXT_ARROW_TAIL;
+    }
+    static bool is_arrow(const st7735_cell_t* cells, uint8_t col)
+    {
+        return static_cast<uint8_t>(cells[col].ch) >= ST7735_TEXT_ARROW &&
+               col + 1 < ST7735_TEXT_COLUMNS &&
+               static_cast<uint8_t>(cells[col + 1].ch) ==
+                   ST7735_TEXT_ARROW_TAIL;
+    }
+    void collect_row(uint8_t row);
+    void add_band(uint8_t row, uint8_t start, uint8_t end);
+    void send_bands();
+    static void compose(void* ctx, size_t band, uint16_t* pixels);
+    void compose_band(const st7735_rect_t& band, uint16_t* pixels) const;
+
+    HT_st7735* _display = nullptr;
+    st7735_cell_t _cells[ST7735_TEXT_ROWS][ST7735_TEXT_COLUMNS]; /* Wanted */
+    st7735_cell_t _shown[ST7735_TEXT_ROWS][ST7735_TEXT_COLUMNS]; /* Panel */
+    uint16_t _margin[ST7735_TEXT_ROWS];     /* Margin colour on the panel */
+    bool _margin_valid[ST7735_TEXT_ROWS];
+    st7735_rect_t _bands[ST7735_TEXT_MAX_BANDS]; /* Pending, in pixels */
+    size_t _n_bands = 0;
+};
@@ -0,0 +1,154 @@
+# Generates the direction arrow sprite atlas of the ST7735 driver.
+#
+# Every arrow is rasterised with 4x4 supersampling into a 14x10 sprite, two
+# Font_7x10 cells, and run-length encoded. The runs alternate between the
+# background and the foreground, starting with the background. Every run is a
+# nibble, high nibble first; longer runs are split by an empty run.
+# Arrow 0 points to the front (up) and every next one is rotated clockwise by
+# 360 / count degrees.
+#
+# Usage:
+#   python3 scripts/arrow_atlas.py                 # rewrite the atlas source
+#   python3 scripts/arrow_atlas.py --preview       # print the arrows
+
+import argparse
+import math
+import os
+
+WIDTH = 14
+HEIGHT = 10
+SUPERSAMPLE = 4
+MAX_RUN = 15
+
+# Arrow pointing up, centred at the origin, in pixels
+HEAD = [(0.0, -5.0), (-4.2, -0.2), (4.2, -0.2)]
+SHAFT = (-1.1, -1.0, 1.1, 5.0)  # x0, y0, x1, y1
+
+OUTPUT = os.path.join(os.path.dirname(__file__), "..", "lib", "ht_st7735",
+                      "HT_st7735_arrows.cpp")
+
+HEADER = """/**
+ * @file HT_st7735_arrows.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Direction arrow sprite atlas, generated by scripts/arrow_atlas.py.
+ * Do not edit, run the script instead.
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+
+#include "HT_st7735_sprite.hpp"
+"""
+
+
+def inside_triangle(px, py, tri):
+    (ax, ay), (bx, by), (cx, cy) = tri
+    d1 = (px - bx) * (ay - by) - (ax - bx) * (py - by)
+    d2 = (px - cx) * (by - cy) - (bx - cx) * (py - cy)
+    d3 = (px - ax) * (cy - ay) - (cx - ax) * (py - ay)
+    neg = d1 < 0 or d2 < 0 or d3 < 0
+    pos = d1 > 0 or d2 > 0 or d3 > 0
+    return not (neg and pos)
+
+
+def inside_arrow(x, y):
+    x0, y0, x1, y1 = SHAFT
+    return inside_triangle(x, y, HEAD) or (x0 <= x <= x1 and y0 <= y <= y1)
+
+
+def rasterise(angle_deg):
+    """Returns HEIGHT rows of WIDTH booleans, the arrow rotated clockwise"""
+    a = math.radians(angle_deg)
+    cos_a, sin_a = math.cos(a), math.sin(a)
+    cx, cy = WIDTH / 2, HEIGHT / 2
+    rows = []
+    for py in range(HEIGHT):
+        row = []
+        for px in range(WIDTH):
+            hits = 0
+            for sy in range(SUPERSAMPLE):
+                for sx in range(SUPERSAMPLE):
+                    x = px + (sx + 0.5) / SUPERSAMPLE - cx
+                    y = py + (sy + 0.5) / SUPERSAMPLE - cy
+                    # Undo the rotation, y grows downwards on the panel
+                    ux = x * cos_a + y * sin_a
+                    uy = -x * sin_a + y * cos_a
+                    hits += inside_arrow(ux, uy)
+            row.append(hits * 2 >= SUPERSAMPLE * SUPERSAMPLE)
+        rows.append(row)
+    return rows
+
+
+def rle(rows):
+    runs = []
+    colour = False
+    length = 0
+    for pixel in (p for row in rows for p in row):
+        if pixel == colour and length < MAX_RUN:
+            length += 1
+            continue
+        if pixel == colour:
+            # Split an overlong run with an empty run of the other colour
+            runs += [length, 0]
+            length = 1
+            continue
+        runs.append(length)
+        colour = pixel
+        length = 1
+    runs.append(length)
+    return runs
+
+
+def pack(runs):
+    if len(runs) % 2:
+        runs = runs + [0]  # Trailing empty run, never reached
+    return [(runs[k] << 4) | runs[k + 1] for k in range(0, len(runs), 2)]
+
+
+def generate(count):
+    sprites = [rasterise(i * 360.0 / count) for i in range(count)]
+    encoded = [pack(rle(s)) for s in sprites]
+    lines = [HEADER]
+    for i, runs in enumerate(encoded):
+        lines.append(f"static const uint8_t arrow_{i}[] = {{")
+        for k in range(0, len(runs), 12):
+            chunk = ", ".join(f"0x{r:02x}" for r in runs[k:k + 12])
+            lines.append(f"    {chunk},")
+        lines.append("};")
+        lines.append("")
+    lines.append("const st7735_sprite_t st7735_arrows[ST7735_ARROW_COUNT] = {")
+    for i in range(count):
+        lines.append(f"    {{ST7735_ARROW_WIDTH, ST7735_ARROW_HEIGHT, arrow_{i}, "
+                     f"sizeof(arrow_{i})}},")
+    lines.append("};")
+    total = sum(len(r) for r in encoded)
+    return "\n".join(lines) + "\n", sprites, total
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the arrow atlas")
+    parser.add_argument("--count", type=int, default=16,
+                        help="Number of arrows, has to match ST7735_ARROW_COUNT")
+    parser.add_argument("--preview", action="store_true",
+                        help="Print the arrows instead of writing the source")
+    args = parser.parse_args()
+
+    source, sprites, total = generate(args.count)
+    if args.preview:
+        for i, rows in enumerate(sprites):
+            print(f"arrow {i} ({i * 360.0 / args.count:.1f} deg)")
+            for row in rows:
+                print("".join("#" if p else "." for p in row))
+        raw = args.count * WIDTH * HEIGHT
+        print(f"{total} bytes of runs, {raw // 8} bytes as 1bpp, "
+              f"{raw * 2} bytes as RGB565")
+        return
+    with open(OUTPUT, "w") as f:
+        f.write(source)
+    print(f"Wrote {os.path.normpath(OUTPUT)}: {total} bytes of runs")
+
+
+if __name__ == "__main__":
+    main()
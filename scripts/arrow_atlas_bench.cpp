@@ -0,0 +1,90 @@
+/**
+ * @file arrow_atlas_bench.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host benchmark of the arrow sprite atlas: decode-plus-blit time per
+ * sprite and the size of the compressed atlas
+ * @version 0.1
+ * @date 2025-07-26
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=gnu++17 -Ilib/ht_st7735 scripts/arrow_atlas_bench.cpp \
+ *       lib/ht_st7735/HT_st7735_arrows.cpp -o /tmp/arrow_atlas_bench
+ *   /tmp/arrow_atlas_bench
+ */
+
+#include "HT_st7735_sprite.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+constexpr int WIDTH = 160;
+constexpr int HEIGHT = 80;
+constexpr int PASSES = 100000;
+/* Strip of the queued path, half of the driver line buffer */
+constexpr size_t STRIP_PIXELS = WIDTH * 26 / 2;
+
+static uint16_t framebuffer[WIDTH * HEIGHT];
+static uint16_t strip[STRIP_PIXELS];
+
+/* Decode a sprite strip by strip and copy it into the framebuffer, what the
+ * driver does with the shadow framebuffer enabled */
+static void blit(const st7735_sprite_t& sp, int x, int y)
+{
+    st7735_rle_decoder rle(sp, 0xFFFF, 0x0000);
+    int rows;
+    for (int row = 0; row < sp.height; row += rows)
+    {
+        rows = std::min<int>(STRIP_PIXELS / sp.width, sp.height - row);
+        rle.read(strip, rows * sp.width);
+        for (int j = 0; j < rows; j++)
+            memcpy(&framebuffer[(y + row + j) * WIDTH + x],
+                   &strip[j * sp.width], sp.width * sizeof(uint16_t));
+    }
+}
+
+template <typename F> static double ns_per_sprite(F f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < PASSES; i++)
+        f(i);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           PASSES;
+}
+
+int main()
+{
+    size_t rle_bytes = 0;
+    for (const st7735_sprite_t& sp : st7735_arrows)
+        rle_bytes += sp.rle_bytes;
+    const size_t pixels = ST7735_ARROW_WIDTH * ST7735_ARROW_HEIGHT;
+    printf("atlas: %u arrows, %zu bytes of runs, %zu as 1bpp, %zu as RGB565\n",
+           ST7735_ARROW_COUNT, rle_bytes, ST7735_ARROW_COUNT * pixels / 8,
+           ST7735_ARROW_COUNT * pixels * sizeof(uint16_t));
+
+    double decode = ns_per_sprite(
+        [](int i)
+        {
+            st7735_rle_decoder rle(st7735_arrows[i % ST7735_ARROW_COUNT],
+                                   0xFFFF, 0x0000);
+            rle.read(strip, STRIP_PIXELS);
+        });
+    double decode_blit = ns_per_sprite(
+        [](int i)
+        {
+            blit(st7735_arrows[i % ST7735_ARROW_COUNT],
+                 (i % 11) * ST7735_ARROW_WIDTH,
+                 (i % 8) * ST7735_ARROW_HEIGHT);
+        });
+    printf("decode: %.1f ns/sprite, decode + blit: %.1f ns/sprite\n", decode,
+           decode_blit);
+
+    /* Keep the framebuffer alive */
+    uint32_t sum = 0;
+    for (uint16_t p : framebuffer)
+        sum += p;
+    printf("checksum: %u\n", sum);
+    return 0;
+}
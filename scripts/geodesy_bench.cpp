@@ -0,0 +1,309 @@
+/**
+ * @file geodesy_bench.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host benchmark of the distance and bearing to the peers: the error
+ * of the integer tangent plane and of the float Haversine against TinyGPSPlus
+ * in double, and the time a refresh of the peers takes with each
+ * @version 0.1
+ * @date 2025-08-07
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=gnu++17 -Ilib/Astrolavos -Ilib/TinyGPSPlus \
+ *       scripts/geodesy_bench.cpp lib/Astrolavos/AstrolavosGeodesy.cpp \
+ *       lib/Astrolavos/AstrolavosTrig.cpp lib/TinyGPSPlus/TinyGPS++.cpp \
+ *       -o /tmp/geodesy_bench
+ *   /tmp/geodesy_bench
+ * -DASTROLAVOS_GEODESY_LANES=1 times the scalar batch code of the target,
+ * -mavx2 -DASTROLAVOS_GEODESY_LANES=4 four lanes.
+ */
+
+#include "AstrolavosGeodesy.hpp"
+#include "Astrolavos_types.hpp"
+#include <TinyGPS++.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace astrolavos;
+
+constexpr double LATITUDES[] = {0, 20, 37.9715, 50, 60, 70, 80, 85};
+constexpr double DISTANCES[] = {10, 100, 1000, 5000, 9900};
+constexpr int PEERS = 10;
+constexpr int REFRESHES = 200000;
+constexpr size_t GROUPS[] = {4, 32, 256};
+constexpr int BATCH_PEERS = 2000000; /* Peers measured per group size */
+constexpr uint8_t SECTORS = 16;
+
+typedef struct
+{
+    double distance;     /* Largest error in m */
+    double relative;     /* Largest error relative to the distance */
+    double bearing;      /* Largest error in degrees */
+    double bearing_100m; /* The same, from 100 m on */
+} errors_t;
+
+static int32_t coordinate(double degrees)
+{
+    return static_cast<int32_t>(lround(degrees * ASTROLAVOS_COORDINATE_SCALE));
+}
+
+static double degrees(int32_t coordinate)
+{
+    return static_cast<double>(coordinate) / ASTROLAVOS_COORDINATE_SCALE;
+}
+
+/* The point at a distance and bearing, on the sphere of EARTH_RADIUS_M */
+static void destination(double lat, double lon, double bearing,
+                        double distance, double& lat2, double& lon2)
+{
+    const double d = distance / EARTH_RADIUS_M;
+    const double b = bearing * DEG_TO_RAD;
+    const double p1 = lat * DEG_TO_RAD;
+    const double p2 = asin(sin(p1) * cos(d) + cos(p1) * sin(d) * cos(b));
+    const double l2 =
+        atan2(sin(b) * sin(d) * cos(p1), cos(d) - sin(p1) * sin(p2));
+    lat2 = p2 * RAD_TO_DEG;
+    lon2 = lon + l2 * RAD_TO_DEG;
+}
+
+static double angle_error(double a, double b)
+{
+    return fabs(fmod(a - b + 540.0, 360.0) - 180.0);
+}
+
+static void account(errors_t& e, double reference, double reference_bearing,
+                    double distance, double bearing)
+{
+    const double err = fabs(distance - reference);
+    e.distance = std::max(e.distance, err);
+    e.relative = std::max(e.relative, err / reference);
+    const double b = angle_error(bearing, reference_bearing);
+    e.bearing = std::max(e.bearing, b);
+    if (reference >= 100)
+        e.bearing_100m = std::max(e.bearing_100m, b);
+}
+
+static void accuracy()
+{
+    printf("Largest error against TinyGPSPlus in double, scaled to a radius "
+           "of %.0f m,\nover 72 bearings and %zu distances from 10 m to "
+           "9.9 km per latitude\n\n",
+           EARTH_RADIUS_M, sizeof(DISTANCES) / sizeof(DISTANCES[0]));
+    printf("%8s | %-37s | %-37s\n", "", "tangent plane", "haversine float");
+    printf("%8s | %8s %8s %9s %9s | %8s %8s %9s %9s\n", "lat", "m", "ppm",
+           "deg", ">=100m", "m", "ppm", "deg", ">=100m");
+    const double scale = EARTH_RADIUS_M / _GPS_EARTH_MEAN_RADIUS;
+    for (double lat : LATITUDES)
+    {
+        errors_t plane = {}, haversine = {};
+        /* A longitude that wraps around within 10 km */
+        const double lon = lat == 0 ? 179.99 : 23.7257;
+        const int32_t lat1 = coordinate(lat), lon1 = coordinate(lon);
+        const geodesy_origin_t origin = geodesyOrigin(lat1, lon1);
+        for (double distance : DISTANCES)
+        {
+            for (int b = 0; b < 360; b += 5)
+            {
+                double dlat2, dlon2;
+                destination(degrees(lat1), degrees(lon1), b, distance, dlat2,
+                            dlon2);
+                if (dlon2 > 180)
+                    dlon2 -= 360;
+                /* The positions are on the grid of the wire, the reference
+                 * gets the same */
+                const int32_t lat2 = coordinate(dlat2);
+                const int32_t lon2 = coordinate(dlon2);
+                const double reference =
+                    TinyGPSPlus::distanceBetween(degrees(lat1), degrees(lon1),
+                                                 degrees(lat2),
+                                                 degrees(lon2)) *
+                    scale;
+                const double reference_bearing =
+                    TinyGPSPlus::courseTo(degrees(lat1), degrees(lon1),
+                                          degrees(lat2), degrees(lon2));
+                account(plane, reference, reference_bearing,
+                        geodesyDistance(origin, lat2, lon2) / 100.0,
+                        geodesyBearing(origin, lat2, lon2) / 100.0);
+                account(haversine, reference, reference_bearing,
+                        haversineDistance(degrees(lat1), degrees(lon1),
+                                          degrees(lat2), degrees(lon2)),
+                        forwardAzimuth(degrees(lat1), degrees(lon1),
+                                       degrees(lat2), degrees(lon2)));
+            }
+        }
+        printf("%8.4f | %8.3f %8.1f %9.4f %9.4f | %8.3f %8.1f %9.4f %9.4f%s\n",
+               lat, plane.distance, plane.relative * 1e6, plane.bearing,
+               plane.bearing_100m, haversine.distance, haversine.relative * 1e6,
+               haversine.bearing, haversine.bearing_100m,
+               origin.local ? "" : "  (haversine)");
+    }
+}
+
+/* Farther than the plane reaches, the same as Haversine */
+static void fallback()
+{
+    const int32_t lat1 = coordinate(37.9715), lon1 = coordinate(23.7257);
+    const geodesy_origin_t origin = geodesyOrigin(lat1, lon1);
+    int n = 0, same = 0;
+    for (double distance = 10100; distance < 100000; distance *= 1.5)
+    {
+        for (int b = 0; b < 360; b += 5, n++)
+        {
+            double dlat2, dlon2;
+            destination(degrees(lat1), degrees(lon1), b, distance, dlat2,
+                        dlon2);
+            const int32_t lat2 = coordinate(dlat2), lon2 = coordinate(dlon2);
+            /* In float as the fallback converts them */
+            const float haversine = haversineDistance(
+                static_cast<float>(lat1) / ASTROLAVOS_COORDINATE_SCALE,
+                static_cast<float>(lon1) / ASTROLAVOS_COORDINATE_SCALE,
+                static_cast<float>(lat2) / ASTROLAVOS_COORDINATE_SCALE,
+                static_cast<float>(lon2) / ASTROLAVOS_COORDINATE_SCALE);
+            const float azimuth = forwardAzimuth(
+                static_cast<float>(lat1) / ASTROLAVOS_COORDINATE_SCALE,
+                static_cast<float>(lon1) / ASTROLAVOS_COORDINATE_SCALE,
+                static_cast<float>(lat2) / ASTROLAVOS_COORDINATE_SCALE,
+                static_cast<float>(lon2) / ASTROLAVOS_COORDINATE_SCALE);
+            same += geodesyDistance(origin, lat2, lon2) ==
+                        static_cast<uint32_t>(lroundf(100 * haversine)) &&
+                    geodesyBearing(origin, lat2, lon2) ==
+                        lroundf(100 * azimuth) % 36000;
+        }
+    }
+    printf("\nFrom 10.1 km to 100 km %d of %d points fall back to Haversine\n",
+           same, n);
+}
+
+static int32_t peers[PEERS][2];
+
+static void timing()
+{
+    for (int i = 0; i < PEERS; i++)
+    {
+        double lat2, lon2;
+        destination(37.9715, 23.7257, i * 36.0, 200 + 500 * i, lat2, lon2);
+        peers[i][0] = coordinate(lat2);
+        peers[i][1] = coordinate(lon2);
+    }
+
+    volatile float sink = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < REFRESHES; r++)
+    {
+        /* Our position moves a little every refresh */
+        const float lat = degrees(379715000 + (r & 15) * 100);
+        const float lon = 23.7257f;
+        for (int i = 0; i < PEERS; i++)
+        {
+            const float lat2 = degrees(peers[i][0]);
+            const float lon2 = degrees(peers[i][1]);
+            sink = sink + haversineDistance(lat, lon, lat2, lon2) +
+                   forwardAzimuth(lat, lon, lat2, lon2);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < REFRESHES; r++)
+    {
+        const geodesy_origin_t origin =
+            geodesyOrigin(379715000 + (r & 15) * 100, 237257000);
+        for (int i = 0; i < PEERS; i++)
+            sink = sink + geodesyDistance(origin, peers[i][0], peers[i][1]) +
+                   geodesyBearing(origin, peers[i][0], peers[i][1]);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    const double haversine_ns =
+        std::chrono::duration<double, std::nano>(t1 - t0).count() /
+        (REFRESHES * PEERS);
+    const double plane_ns =
+        std::chrono::duration<double, std::nano>(t2 - t1).count() /
+        (REFRESHES * PEERS);
+    printf("\nDistance and bearing of %d peers per refresh, %d refreshes\n",
+           PEERS, REFRESHES);
+    printf("  haversine float   %7.1f ns/peer\n", haversine_ns);
+    printf("  tangent plane     %7.1f ns/peer (%.1fx)\n", plane_ns,
+           haversine_ns / plane_ns);
+}
+
+/* geodesyBatch() against a geodesyVector() per peer, as the application
+ * refreshes them, and the sector of each */
+static void batch()
+{
+    printf("\nDistance, bearing and sector of a group, %d lanes, %d peers "
+           "per size\n",
+           ASTROLAVOS_GEODESY_LANES, BATCH_PEERS);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> bearing(0, 360);
+    /* Some farther than the plane reaches */
+    std::uniform_real_distribution<double> distance(10, 9900);
+    for (size_t n : GROUPS)
+    {
+        std::vector<int32_t> latitude(n), longitude(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            double lat2, lon2;
+            destination(37.9715, 23.7257, bearing(rng), distance(rng), lat2,
+                        lon2);
+            latitude[i] = coordinate(lat2);
+            longitude[i] = coordinate(lon2);
+        }
+        std::vector<uint32_t> d1(n), d2(n);
+        std::vector<uint16_t> b1(n), b2(n);
+        std::vector<uint8_t> s1(n), s2(n);
+        const geodesy_batch_t group = {latitude.data(), longitude.data(),
+                                       d2.data(),       b2.data(),
+                                       s2.data(),       n};
+        const int refreshes = BATCH_PEERS / n;
+
+        auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < refreshes; r++)
+        {
+            const geodesy_origin_t origin =
+                geodesyOrigin(379715000 + (r & 15) * 100, 237257000);
+            const uint16_t heading = (r * 100) % 36000;
+            for (size_t i = 0; i < n; i++)
+            {
+                const geodesy_vector_t v =
+                    geodesyVector(origin, latitude[i], longitude[i]);
+                d1[i] = v.distance;
+                b1[i] = v.bearing;
+                const uint32_t relative = (v.bearing + 36000 - heading) % 36000;
+                s1[i] = (relative * SECTORS + 18000) / 36000 % SECTORS;
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        for (int r = 0; r < refreshes; r++)
+        {
+            const geodesy_origin_t origin =
+                geodesyOrigin(379715000 + (r & 15) * 100, 237257000);
+            geodesyBatch(origin, (r * 100) % 36000, SECTORS, group);
+        }
+        auto t2 = std::chrono::steady_clock::now();
+
+        const bool same = d1 == d2 && b1 == b2 && s1 == s2;
+        const double peer_ns =
+            std::chrono::duration<double, std::nano>(t1 - t0).count() /
+            (refreshes * n);
+        const double batch_ns =
+            std::chrono::duration<double, std::nano>(t2 - t1).count() /
+            (refreshes * n);
+        printf("  N = %3zu  per peer %6.1f ns/peer  batch %6.1f ns/peer "
+               "(%.1fx)%s\n",
+               n, peer_ns, batch_ns, peer_ns / batch_ns,
+               same ? "" : "  RESULTS DIFFER");
+    }
+}
+
+int main()
+{
+    accuracy();
+    fallback();
+    timing();
+    batch();
+    return 0;
+}
@@ -0,0 +1,240 @@
+# Encodes images into the palette plus run-length format of the ST7735 driver,
+# see lib/ht_st7735/HT_st7735_image.hpp.
+#
+# Every run is a byte holding the palette index in the high nibble and the
+# length minus one in the low nibble. A low nibble of 15 means that the length
+# is 16 plus the next byte.
+#
+# Usage:
+#   python3 scripts/rle_image.py splash              # rewrite the boot splash
+#   python3 scripts/rle_image.py splash --preview    # print the splash
+#   python3 scripts/rle_image.py ppm icon.ppm icon out.cpp [--namespace ns]
+#
+# PPM images (P6 or P3) may use up to 16 distinct colours, which are converted
+# to RGB565 in order of appearance.
+
+import argparse
+import math
+import os
+
+MAX_COLORS = 16
+LONG_RUN = 15
+MAX_RUN = LONG_RUN + 1 + 255
+
+ROOT = os.path.join(os.path.dirname(__file__), "..")
+SPLASH_OUTPUT = os.path.join(ROOT, "lib", "Astrolavos", "AstrolavosSplash.cpp")
+
+HEADER = """/**
+ * @file {file}
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief {brief}, generated by scripts/rle_image.py.
+ * Do not edit, run the script instead.
+ * @version 0.1
+ * @date 2025-07-27
+ *
+ * @copyright Copyright (c) 2025
+ *
+ */
+"""
+
+# Splash emblem, an astrolabe. Index 1 is replaced by the device colour at run
+# time, so the value in flash is only a placeholder
+SPLASH_SIZE = 36
+SPLASH_PALETTE = [0x0000, 0x07FF, 0xFFFF]
+SUPERSAMPLE = 4
+
+
+def rgb565(r, g, b):
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+
+
+def encode(pixels):
+    """Encode rows of palette indices into runs"""
+    flat = [p for row in pixels for p in row]
+    out = []
+    k = 0
+    while k < len(flat):
+        index = flat[k]
+        length = 1
+        while (k + length < len(flat) and flat[k + length] == index and
+               length < MAX_RUN):
+            length += 1
+        if length <= LONG_RUN:
+            out.append((index << 4) | (length - 1))
+        else:
+            out += [(index << 4) | LONG_RUN, length - LONG_RUN - 1]
+        k += length
+    return out
+
+
+def decode(runs, count):
+    """Reference decoder, used to check the encoder"""
+    flat = []
+    k = 0
+    while k < len(runs):
+        index, length = runs[k] >> 4, (runs[k] & 0x0F) + 1
+        k += 1
+        if length == LONG_RUN + 1:
+            length += runs[k]
+            k += 1
+        flat += [index] * length
+    return flat[:count]
+
+
+def splash_pixel(x, y):
+    """Palette index of the emblem at a sub-pixel position"""
+    c = SPLASH_SIZE / 2
+    dx, dy = x - c, y - c
+    r = math.hypot(dx, dy)
+    angle = math.degrees(math.atan2(dx, -dy)) % 360
+    # The alidade, a rule through the centre, over everything but the pin
+    rule = math.radians(35)
+    along = dx * math.sin(rule) - dy * math.cos(rule)
+    across = dx * math.cos(rule) + dy * math.sin(rule)
+    if r < 2.2:
+        return 1
+    if abs(across) < 1.0 and abs(along) < 14.0:
+        return 2
+    if 15.0 <= r < 17.0:
+        return 1
+    # Hour ticks on the limb, longer at the quarters
+    tick = min(angle % 30, 30 - angle % 30)
+    inner = 11.0 if angle % 90 < 1 or angle % 90 > 89 else 12.5
+    if inner <= r < 15.0 and tick * math.pi / 180 * r < 0.7:
+        return 2
+    if 8.0 <= r < 9.2:
+        return 1
+    return 0
+
+
+def rasterise_splash():
+    pixels = []
+    for j in range(SPLASH_SIZE):
+        row = []
+        for i in range(SPLASH_SIZE):
+            votes = [0] * len(SPLASH_PALETTE)
+            for sj in range(SUPERSAMPLE):
+                for si in range(SUPERSAMPLE):
+                    votes[splash_pixel(i + (si + 0.5) / SUPERSAMPLE,
+                                       j + (sj + 0.5) / SUPERSAMPLE)] += 1
+            row.append(max(range(len(votes)), key=lambda v: votes[v]))
+        pixels.append(row)
+    return pixels
+
+
+def read_ppm(path):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic = data[:2]
+    if magic not in (b"P6", b"P3"):
+        raise SystemExit(f"{path}: not a P6 or P3 PPM image")
+    # Header fields, skipping comments
+    fields = []
+    pos = 2
+    while len(fields) < 3:
+        while data[pos:pos + 1].isspace():
+            pos += 1
+        if data[pos:pos + 1] == b"#":
+            pos = data.index(b"\n", pos)
+            continue
+        end = pos
+        while not data[end:end + 1].isspace():
+            end += 1
+        fields.append(int(data[pos:end]))
+        pos = end
+    width, height, maxval = fields
+    if magic == b"P6":
+        values = data[pos + 1:pos + 1 + width * height * 3]
+    else:
+        values = [int(v) for v in data[pos:].split()]
+    values = [v * 255 // maxval for v in values]
+    colours = [rgb565(*values[k:k + 3]) for k in range(0, len(values), 3)]
+    return width, height, colours
+
+
+def index_colours(width, height, colours):
+    palette = []
+    pixels = []
+    for j in range(height):
+        row = []
+        for c in colours[j * width:(j + 1) * width]:
+            if c not in palette:
+                palette.append(c)
+            row.append(palette.index(c))
+        pixels.append(row)
+    if len(palette) > MAX_COLORS:
+        raise SystemExit(f"{len(palette)} colours, at most {MAX_COLORS}")
+    return palette, pixels
+
+
+def source(path, brief, name, palette, pixels, namespace, include):
+    runs = encode(pixels)
+    width, height = len(pixels[0]), len(pixels)
+    assert decode(runs, width * height) == [p for r in pixels for p in r]
+    lines = [HEADER.format(file=os.path.basename(path), brief=brief),
+             f'#include "{include}"', ""]
+    if namespace:
+        lines += [f"namespace {namespace}", "{", ""]
+    lines.append(f"static const uint16_t {name}_palette[] = {{")
+    lines.append("    " + ", ".join(f"0x{c:04X}" for c in palette) + ",")
+    lines.append("};")
+    lines.append("")
+    lines.append(f"static const uint8_t {name}_rle[] = {{")
+    for k in range(0, len(runs), 12):
+        chunk = ", ".join(f"0x{r:02x}" for r in runs[k:k + 12])
+        lines.append(f"    {chunk},")
+    lines.append("};")
+    lines.append("")
+    # Without the declaration a const object would not be visible outside
+    lines.append(f"extern const st7735_image_t {name};")
+    lines.append(f"const st7735_image_t {name} = {{")
+    for field in (width, height, f"sizeof({name}_palette) / sizeof(uint16_t)",
+                  f"{name}_palette", f"{name}_rle", f"sizeof({name}_rle)"):
+        lines.append(f"    {field},")
+    lines.append("};")
+    if namespace:
+        lines += ["", f"}} // namespace {namespace}"]
+    return "\n".join(lines) + "\n", len(runs)
+
+
+def write(path, text, runs, width, height):
+    with open(path, "w") as f:
+        f.write(text)
+    print(f"Wrote {os.path.normpath(path)}: {runs} bytes of runs, "
+          f"{width * height * 2} bytes as RGB565")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    sub = parser.add_subparsers(dest="command", required=True)
+    splash = sub.add_parser("splash", help="rewrite the boot splash emblem")
+    splash.add_argument("--preview", action="store_true")
+    ppm = sub.add_parser("ppm", help="encode a PPM image")
+    ppm.add_argument("image")
+    ppm.add_argument("name", help="name of the st7735_image_t")
+    ppm.add_argument("output", help="C++ source to write")
+    ppm.add_argument("--namespace", default="")
+    ppm.add_argument("--include", default="HT_st7735_image.hpp")
+    args = parser.parse_args()
+
+    if args.command == "splash":
+        pixels = rasterise_splash()
+        if args.preview:
+            for row in pixels:
+                print("".join(" #o"[p] * 2 for p in row))
+            print(f"{len(encode(pixels))} bytes of runs")
+            return
+        text, runs = source(SPLASH_OUTPUT, "Boot splash emblem",
+                            "astrolavos_splash", SPLASH_PALETTE, pixels,
+                            "astrolavos", "HT_st7735_image.hpp")
+        write(SPLASH_OUTPUT, text, runs, SPLASH_SIZE, SPLASH_SIZE)
+    else:
+        width, height, colours = read_ppm(args.image)
+        palette, pixels = index_colours(width, height, colours)
+        text, runs = source(args.output, f"{args.name} image", args.name,
+                            palette, pixels, args.namespace, args.include)
+        write(args.output, text, runs, width, height)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,164 @@
+/**
+ * @file trig_bench.cpp
+ * @author Evangelos Petrongonas (vpetrog@ieee.org)
+ * @brief Host benchmark of the CORDIC trigonometry: the error of sin, cos
+ * and atan2 against libm in double for a range of iterations, a check of the
+ * integer square root, and the time of each against the float routines
+ * @version 0.1
+ * @date 2025-08-09
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * Build and run from the repository root:
+ *   g++ -O2 -std=gnu++17 -Ilib/Astrolavos scripts/trig_bench.cpp \
+ *       lib/Astrolavos/AstrolavosTrig.cpp -o /tmp/trig_bench
+ *   /tmp/trig_bench
+ */
+
+#include "AstrolavosTrig.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace astrolavos;
+
+constexpr int ITERATIONS[] = {8, 12, 16, 20, 24, 30};
+constexpr int ANGLES = 100000;
+constexpr int CALLS = 2000000;
+constexpr double TURN = 4294967296.0;
+
+static double degrees_of(trig_angle_t angle) { return angle / TURN * 360; }
+
+static double angle_error(double a, double b)
+{
+    return fabs(fmod(a - b + 540.0, 360.0) - 180.0);
+}
+
+static double atan2_error(int32_t y, int32_t x, int iterations)
+{
+    return angle_error(degrees_of(trigAtan2(y, x, iterations)),
+                       atan2(y, x) * 180 / M_PI);
+}
+
+static void accuracy()
+{
+    printf("Largest error against libm in double over %d angles and "
+           "vectors\n\n",
+           ANGLES);
+    printf("%10s | %12s %12s | %12s %12s\n", "iterations", "sin, cos",
+           "", "atan2 deg", "");
+    printf("%10s | %12s %12s | %12s %12s\n", "", "Q30 LSB", "abs", "int16",
+           "2^28");
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<uint32_t> angle(0, UINT32_MAX);
+    std::uniform_int_distribution<int32_t> magnetometer(-2000, 2000);
+    std::uniform_int_distribution<int32_t> large(-(1 << 28), 1 << 28);
+    for (int iterations : ITERATIONS)
+    {
+        double sincos = 0, small = 0, big = 0;
+        for (int i = 0; i < ANGLES; i++)
+        {
+            const trig_angle_t a = angle(rng);
+            const double rad = a / TURN * 2 * M_PI;
+            int32_t s, c;
+            trigSinCos(a, s, c, iterations);
+            sincos = std::max(sincos, fabs(s - sin(rad) * (1 << 30)));
+            sincos = std::max(sincos, fabs(c - cos(rad) * (1 << 30)));
+
+            /* Calibrated magnetometer readings, and offsets of the plane */
+            const int32_t mx = magnetometer(rng), my = magnetometer(rng);
+            const int32_t lx = large(rng), ly = large(rng);
+            if (mx || my)
+                small = std::max(small, atan2_error(my, mx, iterations));
+            big = std::max(big, atan2_error(ly, lx, iterations));
+        }
+        printf("%10d | %12.1f %12.2e | %12.6f %12.6f\n", iterations, sincos,
+               sincos / (1 << 30), small, big);
+    }
+}
+
+static void square_root()
+{
+    std::mt19937_64 rng(1);
+    int n = 0, exact = 0;
+    for (int bits = 1; bits <= 64; bits++)
+    {
+        const uint64_t top = bits == 64 ? UINT64_MAX : (1ULL << bits) - 1;
+        std::uniform_int_distribution<uint64_t> value(top >> 1, top);
+        for (int i = 0; i < 1000; i++, n++)
+        {
+            const uint64_t v = value(rng);
+            const uint64_t r = trigSqrt(v);
+            /* r * r <= v < (r + 1)^2, the second in 128 bits */
+            exact += r * r <= v &&
+                     static_cast<unsigned __int128>(r + 1) * (r + 1) > v;
+        }
+    }
+    printf("\ntrigSqrt() is the floor of the root for %d of %d values of 1 "
+           "to 64 bits\n",
+           exact, n);
+}
+
+template <typename F> static double time_ns(F f)
+{
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < CALLS; i++)
+        f(i);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / CALLS;
+}
+
+static void timing()
+{
+    volatile float fsink = 0;
+    volatile int32_t isink = 0;
+    printf("\nTime per call, %d calls\n", CALLS);
+    const double libm_sincos = time_ns(
+        [&](int i)
+        {
+            const float rad = i * 3.1e-6f;
+            fsink = fsink + sinf(rad) + cosf(rad);
+        });
+    printf("  sinf + cosf          %6.1f ns\n", libm_sincos);
+    for (int iterations : {16, ASTROLAVOS_TRIG_ITERATIONS})
+    {
+        const double ns = time_ns(
+            [&](int i)
+            {
+                int32_t s, c;
+                trigSinCos(static_cast<trig_angle_t>(i) * 2147, s, c,
+                           iterations);
+                isink = isink + s + c;
+            });
+        printf("  trigSinCos %2d        %6.1f ns (%.1fx)\n", iterations, ns,
+               libm_sincos / ns);
+    }
+    const double libm_atan2 = time_ns(
+        [&](int i)
+        {
+            fsink = fsink + atan2f(static_cast<float>((i & 4095) - 2048),
+                                   static_cast<float>((i >> 12) - 244));
+        });
+    printf("  atan2f               %6.1f ns\n", libm_atan2);
+    for (int iterations : {16, ASTROLAVOS_TRIG_ITERATIONS})
+    {
+        const double ns = time_ns(
+            [&](int i)
+            {
+                isink = isink + trigAtan2((i & 4095) - 2048, (i >> 12) - 244,
+                                          iterations);
+            });
+        printf("  trigAtan2 %2d         %6.1f ns (%.1fx)\n", iterations, ns,
+               libm_atan2 / ns);
+    }
+}
+
+int main()
+{
+    accuracy();
+    square_root();
+    timing();
+    return 0;
+}
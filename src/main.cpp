@@ -17,6 +17,7 @@
 #include <Astrolavos.hpp>
 #include <BatteryMonitor.hpp>
 #include <HT_st7735.hpp>
+#include <HT_st7735_renderer.hpp>
 #include <LoRaMockup.hpp>
 #include <QMC5883L.hpp>
 #include <gnss.hpp>
@@ -60,6 +61,7 @@ void blinking_task(void* args)
 extern "C" void app_main()
 {
     HT_st7735 display;
+    static HT_st7735_renderer renderer; /* Too big for the main task stack */
     astrolavos::Astrolavos astrolavos_app;
     LoRa lora;
     esp_err_t err = nvs_flash_init();
@@ -75,6 +77,13 @@ extern "C" void app_main()
 
     display.init();
     display.set_backlight(80);
+#if defined(ASTROLAVOS_RGB444)
+    display.set_pixel_format(ST7735_PIXEL_RGB444);
+#endif
+#if !defined(ASTROLAVOS_NO_FRAMEBUFFER)
+    if (display.enable_framebuffer() != ESP_OK)
+        ESP_LOGW(TAG, "Running without a framebuffer, expect some flicker");
+#endif
     lora.init();
     esp_pm_config_t pm_config = {
         .max_freq_mhz = 240,
@@ -84,8 +93,18 @@ extern "C" void app_main()
 
     ESP_ERROR_CHECK(esp_pm_configure(&pm_config));
 
+#if defined(ST7735_BENCHMARK)
+    xTaskCreate(st7735_benchmark_task, "st7735_benchmark_task", 4096, &display,
+                5, NULL);
+    vTaskSuspend(NULL);
+#endif
+
+    ESP_ERROR_CHECK(renderer.init(&display));
+    xTaskCreate(display_render_task, "display_render_task", 4096, &renderer, 5,
+                NULL);
+
     astrolavos::astrolavos_args_t task_args = {
-        .display = &display,
+        .renderer = &renderer,
         .lora = &lora,
         .app = &astrolavos_app,
     };